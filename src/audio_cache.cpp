@@ -0,0 +1,100 @@
+#include "audio_cache.h"
+
+AudioCache& AudioCache::Instance() {
+    static AudioCache instance;
+    return instance;
+}
+
+void AudioCache::SetCapacityBytes(size_t capacity_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_bytes_ = capacity_bytes;
+    EvictLocked();
+}
+
+/**
+ * 生成缓存键：文件不存在或无法访问时返回空串 (不缓存)
+ */
+std::string AudioCache::MakeKey(const std::string& path, int target_rate) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return "";
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return "";
+    std::ostringstream key;
+    key << path << '|' << mtime.time_since_epoch().count() << '|' << size << '|' << target_rate;
+    return key.str();
+}
+
+AudioCache::AudioDataPtr AudioCache::GetOrLoad(const std::string& path, int target_rate, const Loader& loader) {
+    const std::string key = MakeKey(path, target_rate);
+    if (key.empty()) {
+        return std::make_shared<const AudioFileReader::AudioData>(loader());
+    }
+    
+    std::promise<AudioDataPtr> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            stats_.hits++;
+            return it->second->audio;
+        }
+        auto loading = loading_.find(key);
+        if (loading != loading_.end()) {
+            // 其他线程正在解码同一文件，等待其结果
+            auto future = loading->second;
+            stats_.hits++;
+            lock.unlock();
+            return future.get();
+        }
+        stats_.misses++;
+        loading_.emplace(key, promise.get_future().share());
+    }
+    
+    AudioDataPtr audio;
+    try {
+        audio = std::make_shared<const AudioFileReader::AudioData>(loader());
+    } catch (...) {
+        audio = std::make_shared<const AudioFileReader::AudioData>();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loading_.erase(key);
+        size_t bytes = audio->samples.size() * sizeof(float);
+        if (audio->IsValid() && bytes <= capacity_bytes_) {
+            lru_.push_front(Entry{key, audio, bytes});
+            index_[key] = lru_.begin();
+            used_bytes_ += bytes;
+            EvictLocked();
+        }
+    }
+    promise.set_value(audio);
+    return audio;
+}
+
+void AudioCache::EvictLocked() {
+    while (used_bytes_ > capacity_bytes_ && !lru_.empty()) {
+        const Entry& victim = lru_.back();
+        used_bytes_ -= victim.bytes;
+        index_.erase(victim.key);
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+AudioCache::Stats AudioCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.bytes = used_bytes_;
+    stats.entries = lru_.size();
+    return stats;
+}
+
+void AudioCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    used_bytes_ = 0;
+}
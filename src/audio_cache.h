@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "utils.h"
+
+/**
+ * 解码音频 LRU 缓存 - 进程级单例
+ * 
+ * 🆕 缓存已解码 (并按目标采样率重采样) 的 PCM，避免同一文件在预检查和
+ * 各测试阶段反复读取解码：
+ * - 键: 路径 + 修改时间 + 文件大小 + 目标采样率，文件变化后自动失效
+ * - 按字节预算做 LRU 淘汰，单个超出预算的文件不入缓存
+ * - 多线程安全，同一文件并发未命中时只解码一次，其余线程等待结果
+ */
+class AudioCache {
+public:
+    using AudioDataPtr = AudioFileReader::AudioDataPtr;
+    using Loader = std::function<AudioFileReader::AudioData()>;
+    
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t bytes = 0;
+        size_t entries = 0;
+        double HitRate() const {
+            uint64_t total = hits + misses;
+            return total > 0 ? double(hits) / total * 100.0 : 0.0;
+        }
+    };
+    
+    static AudioCache& Instance();
+    
+    /**
+     * 设置字节预算，0 表示禁用缓存 (超出部分立即淘汰)
+     */
+    void SetCapacityBytes(size_t capacity_bytes);
+    
+    /**
+     * 查找缓存，未命中时调用 loader 解码并插入
+     * 
+     * @param path 音频文件路径
+     * @param target_rate 目标采样率 (0 表示保持原始采样率)
+     * @param loader 解码函数，返回已重采样的音频
+     */
+    AudioDataPtr GetOrLoad(const std::string& path, int target_rate, const Loader& loader);
+    
+    Stats GetStats() const;
+    void Clear();
+
+private:
+    AudioCache() = default;
+    
+    struct Entry {
+        std::string key;
+        AudioDataPtr audio;
+        size_t bytes = 0;
+    };
+    
+    static std::string MakeKey(const std::string& path, int target_rate);
+    void EvictLocked();
+    
+    mutable std::mutex mutex_;
+    size_t capacity_bytes_ = 0;
+    size_t used_bytes_ = 0;
+    std::list<Entry> lru_;                                              // 头部为最近使用
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::unordered_map<std::string, std::shared_future<AudioDataPtr>> loading_;  // 正在解码的文件
+    Stats stats_;
+};
@@ -0,0 +1,84 @@
+#include "audio_prefetcher.h"
+
+AudioPrefetcher::AudioPrefetcher(std::vector<std::string> paths, Loader loader,
+                                 int io_threads, size_t queue_capacity)
+    : paths_(std::move(paths)),
+      loader_(std::move(loader)),
+      capacity_(std::max<size_t>(1, queue_capacity)) {
+    int num_threads = std::max(1, std::min(io_threads, static_cast<int>(paths_.size())));
+    for (int i = 0; i < num_threads && !paths_.empty(); ++i) {
+        workers_.emplace_back(&AudioPrefetcher::IOWorker, this);
+    }
+}
+
+AudioPrefetcher::~AudioPrefetcher() {
+    Stop();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void AudioPrefetcher::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    ready_cv_.notify_all();
+    space_cv_.notify_all();
+}
+
+/**
+ * I/O线程：在预取窗口内按顺序认领文件并加载
+ */
+void AudioPrefetcher::IOWorker() {
+    while (true) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            space_cv_.wait(lock, [this]() {
+                return stopped_ || next_to_load_ >= paths_.size() ||
+                       next_to_load_ < next_to_deliver_ + capacity_;
+            });
+            if (stopped_ || next_to_load_ >= paths_.size()) return;
+            index = next_to_load_++;
+        }
+        
+        Item item;
+        item.index = index;
+        item.path = paths_[index];
+        Timer load_timer;
+        try {
+            item.audio = loader_(item.path);
+        } catch (const std::exception& e) {
+            Logger::Error("预取音频异常: {} - {}", item.path, e.what());
+        }
+        if (!item.audio) {
+            item.audio = std::make_shared<const AudioFileReader::AudioData>();
+        }
+        item.load_ms = load_timer.ElapsedMs();
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.emplace(index, std::move(item));
+        }
+        ready_cv_.notify_all();
+    }
+}
+
+bool AudioPrefetcher::Next(Item& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (next_to_deliver_ >= paths_.size()) return false;
+    
+    ready_cv_.wait(lock, [this]() {
+        return stopped_ || ready_.count(next_to_deliver_) > 0;
+    });
+    auto it = ready_.find(next_to_deliver_);
+    if (it == ready_.end()) return false;  // 已停止
+    
+    item = std::move(it->second);
+    ready_.erase(it);
+    next_to_deliver_++;
+    lock.unlock();
+    space_cv_.notify_all();
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils.h"
+
+/**
+ * 异步预取音频加载器
+ * 
+ * 🆕 后台I/O线程提前解码/重采样后续文件，识别线程只从就绪队列取数据，
+ * 磁盘读取和解码不再计入推理耗时，I/O与计算重叠执行。
+ * 
+ * - 按输入顺序交付，Next()阻塞直到下一个文件就绪
+ * - 预取窗口有界：已加载未取走的文件数不超过queue_capacity
+ * - 析构时停止并回收所有I/O线程
+ */
+class AudioPrefetcher {
+public:
+    struct Item {
+        size_t index = 0;                       // 在输入列表中的下标
+        std::string path;                       // 文件路径
+        AudioFileReader::AudioDataPtr audio;    // 解码结果 (非空，加载失败时为无效数据)
+        double load_ms = 0.0;                   // 后台加载耗时
+    };
+    
+    using Loader = std::function<AudioFileReader::AudioDataPtr(const std::string&)>;
+    
+    AudioPrefetcher(std::vector<std::string> paths, Loader loader,
+                    int io_threads = 2, size_t queue_capacity = 4);
+    ~AudioPrefetcher();
+    
+    AudioPrefetcher(const AudioPrefetcher&) = delete;
+    AudioPrefetcher& operator=(const AudioPrefetcher&) = delete;
+    
+    /**
+     * 取出下一个文件 (按输入顺序)，全部取完返回false
+     */
+    bool Next(Item& item);
+    
+    /**
+     * 停止预取，唤醒所有等待线程
+     */
+    void Stop();
+    
+    size_t Size() const { return paths_.size(); }
+
+private:
+    void IOWorker();
+
+    std::vector<std::string> paths_;
+    Loader loader_;
+    size_t capacity_;
+    
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;     // 通知消费者有文件就绪
+    std::condition_variable space_cv_;     // 通知I/O线程窗口有空位
+    std::map<size_t, Item> ready_;         // 已加载待取走的文件
+    size_t next_to_load_ = 0;              // 下一个待认领的下标
+    size_t next_to_deliver_ = 0;           // 下一个交付的下标
+    bool stopped_ = false;
+    
+    std::vector<std::thread> workers_;
+};
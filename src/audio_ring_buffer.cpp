@@ -0,0 +1,126 @@
+#include "audio_ring_buffer.h"
+#include <algorithm>
+#include <cstring>
+
+void AudioRingBuffer::SetCapacity(size_t capacity_samples) {
+    capacity_ = capacity_samples;
+    storage_.reset();
+    pins_.clear();
+    begin_ = end_ = 0;
+}
+
+void AudioRingBuffer::Allocate() {
+    if (!storage_ && capacity_ > 0) {
+        storage_ = std::make_shared<Storage>();
+        storage_->samples.resize(capacity_ * 2);
+    }
+}
+
+/**
+ * 写入不跨越容量边界的一段样本 (同时写入镜像位置)
+ */
+void AudioRingBuffer::WriteContiguous(Storage& storage, uint64_t position, const float* samples, size_t count) const {
+    size_t index = static_cast<size_t>(position % capacity_);
+    std::memcpy(storage.samples.data() + index, samples, count * sizeof(float));
+    std::memcpy(storage.samples.data() + index + capacity_, samples, count * sizeof(float));
+}
+
+void AudioRingBuffer::Append(const float* samples, size_t count) {
+    if (capacity_ == 0 || count == 0) return;
+    if (count > capacity_) {
+        // 单次写入超过容量: 只保留末尾capacity_个样本 (跳过的样本在下方推进begin_时计入dropped_)
+        size_t skipped = count - capacity_;
+        end_ += skipped;
+        samples += skipped;
+        count = capacity_;
+    }
+    Allocate();
+
+    // 写入位置p会覆盖p-容量处的样本；仍被视图引用的最早位置 + 容量即为安全上限
+    const uint64_t new_end = end_ + count;
+    for (auto it = pins_.begin(); it != pins_.end();) {
+        if (it->second.expired()) {
+            it = pins_.erase(it);
+        } else if (new_end > it->first + capacity_) {
+            Detach();
+            break;
+        } else {
+            ++it;
+        }
+    }
+
+    if (new_end - begin_ > capacity_) {
+        uint64_t new_begin = new_end - capacity_;
+        dropped_ += new_begin - begin_;
+        begin_ = new_begin;
+    }
+
+    while (count > 0) {
+        size_t index = static_cast<size_t>(end_ % capacity_);
+        size_t run = std::min(count, capacity_ - index);
+        WriteContiguous(*storage_, end_, samples, run);
+        end_ += run;
+        samples += run;
+        count -= run;
+    }
+}
+
+/**
+ * 写时复制: 新存储只拷贝保留区间，旧存储由视图继续持有
+ */
+void AudioRingBuffer::Detach() {
+    auto old_storage = storage_;
+    storage_ = std::make_shared<Storage>();
+    storage_->samples.resize(capacity_ * 2);
+    pins_.clear();
+
+    if (begin_ < end_) {
+        const float* retained = old_storage->samples.data() + static_cast<size_t>(begin_ % capacity_);
+        uint64_t position = begin_;
+        size_t remaining = Size();
+        while (remaining > 0) {
+            size_t index = static_cast<size_t>(position % capacity_);
+            size_t run = std::min(remaining, capacity_ - index);
+            WriteContiguous(*storage_, position, retained, run);
+            retained += run;
+            position += run;
+            remaining -= run;
+        }
+    }
+}
+
+void AudioRingBuffer::DiscardBefore(uint64_t position) {
+    begin_ = std::max(begin_, std::min(position, end_));
+}
+
+AudioView AudioRingBuffer::View(uint64_t begin, uint64_t end) {
+    AudioView view;
+    begin = std::max(begin, begin_);
+    end = std::min(end, end_);
+    if (!storage_ || begin >= end) return view;
+
+    auto pin = std::make_shared<const Pin>(Pin{storage_});
+    pins_.emplace_back(begin, pin);
+    view.data = storage_->samples.data() + static_cast<size_t>(begin % capacity_);
+    view.size = static_cast<size_t>(end - begin);
+    view.owner = std::move(pin);
+    return view;
+}
+
+bool AudioRingBuffer::HasLivePins() {
+    pins_.erase(std::remove_if(pins_.begin(), pins_.end(),
+                               [](const auto& pin) { return pin.second.expired(); }),
+                pins_.end());
+    return !pins_.empty();
+}
+
+void AudioRingBuffer::Clear() {
+    // 位置归零后新写入会落在视图仍在读取的下标上，存在未释放视图时换用新存储
+    if (HasLivePins()) {
+        storage_.reset();
+        pins_.clear();
+        Allocate();
+    }
+    begin_ = end_ = 0;
+    dropped_ = 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * 音频片段只读视图 - 共享持有底层存储，跨线程传递无需拷贝
+ */
+struct AudioView {
+    std::shared_ptr<const void> owner;   // 保持存储存活 (环形缓冲据此判断片段是否仍在使用)
+    const float* data = nullptr;
+    size_t size = 0;
+
+    bool Empty() const { return size == 0; }
+};
+
+/**
+ * 固定容量环形音频缓冲 - 会话级有界音频保留
+ *
+ * 🆕 替代不断insert的整段vector:
+ * - 以绝对样本位置寻址，DiscardBefore丢弃已定稿的音频，超出容量时覆盖最旧样本
+ * - 存储为两倍容量的镜像布局 (每个样本同时写入i与i+容量)，任意不超过容量的区间都是连续内存，
+ *   View直接返回指向存储的零拷贝视图
+ * - 写入将覆盖仍被视图引用的区域时，改用新存储并只拷贝保留区间 (写时复制)，旧视图保持有效
+ *
+ * 非线程安全: 由会话线程写入，视图可在任意线程读取与释放。
+ */
+class AudioRingBuffer {
+public:
+    explicit AudioRingBuffer(size_t capacity_samples = 0) : capacity_(capacity_samples) {}
+
+    /**
+     * 设置容量并清空 (存储在Allocate或首次写入时分配)
+     */
+    void SetCapacity(size_t capacity_samples);
+
+    /**
+     * 立即分配存储 (会话池预分配时调用)
+     */
+    void Allocate();
+
+    void Append(const float* samples, size_t count);
+    void Append(const std::vector<float>& samples) { Append(samples.data(), samples.size()); }
+
+    /**
+     * 丢弃position之前的样本 (绝对位置)
+     */
+    void DiscardBefore(uint64_t position);
+
+    /**
+     * 取得[begin, end)的零拷贝视图，区间按当前保留范围截断
+     */
+    AudioView View(uint64_t begin, uint64_t end);
+
+    /**
+     * 清空并把位置与覆盖计数归零，存储仍被视图引用时改用新存储
+     */
+    void Clear();
+
+    uint64_t BeginPosition() const { return begin_; }     // 最旧保留样本的绝对位置
+    uint64_t EndPosition() const { return end_; }         // 已写入样本总数
+    size_t Size() const { return static_cast<size_t>(end_ - begin_); }
+    size_t Capacity() const { return capacity_; }
+    uint64_t DroppedSamples() const { return dropped_; }  // 超出容量被覆盖的样本数
+
+private:
+    struct Storage {
+        std::vector<float> samples;      // 2 × capacity_，镜像布局
+    };
+
+    // 视图持有的引用: 登记起始位置，失效后不再约束写入
+    struct Pin {
+        std::shared_ptr<const Storage> storage;
+    };
+
+    bool HasLivePins();
+    void Detach();
+    void WriteContiguous(Storage& storage, uint64_t position, const float* samples, size_t count) const;
+
+    size_t capacity_ = 0;
+    std::shared_ptr<Storage> storage_;
+    std::deque<std::pair<uint64_t, std::weak_ptr<const Pin>>> pins_;
+    uint64_t begin_ = 0;
+    uint64_t end_ = 0;
+    uint64_t dropped_ = 0;
+};
@@ -0,0 +1,83 @@
+#include "chunk_size_controller.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdlib>
+
+const std::vector<ChunkSizeController::Profile>& ChunkSizeController::AllProfiles() {
+    // 小分块时加大回看块数，使编码器可见的历史上下文大致不变 (约2.4秒)
+    static const std::vector<Profile> profiles = {
+        {300, {0, 5, 5}, 8, 2},
+        {600, {0, 10, 5}, 4, 1},
+        {960, {0, 16, 8}, 3, 1},
+    };
+    return profiles;
+}
+
+bool ChunkSizeController::HasProfileInRange(int min_chunk_ms, int max_chunk_ms) {
+    for (const auto& profile : AllProfiles()) {
+        if (profile.chunk_ms >= min_chunk_ms && profile.chunk_ms <= max_chunk_ms) return true;
+    }
+    return false;
+}
+
+ChunkSizeController::ChunkSizeController(const Options& options) : options_(options) {
+    for (const auto& profile : AllProfiles()) {
+        if (profile.chunk_ms >= options_.min_chunk_ms && profile.chunk_ms <= options_.max_chunk_ms) {
+            profiles_.push_back(profile);
+        }
+    }
+    if (profiles_.empty()) {
+        // 上下限之间没有内置档位: 退回最接近下限的一档
+        const Profile* nearest = &AllProfiles().front();
+        for (const auto& profile : AllProfiles()) {
+            if (std::abs(profile.chunk_ms - options_.min_chunk_ms) < std::abs(nearest->chunk_ms - options_.min_chunk_ms)) {
+                nearest = &profile;
+            }
+        }
+        profiles_.push_back(*nearest);
+        Logger::Warn("自适应分块范围{}-{}ms内没有内置档位，固定使用{}ms", options_.min_chunk_ms,
+                     options_.max_chunk_ms, nearest->chunk_ms);
+    }
+    for (size_t i = 0; i < profiles_.size(); ++i) {
+        if (std::abs(profiles_[i].chunk_ms - options_.initial_chunk_ms) <
+            std::abs(profiles_[current_].chunk_ms - options_.initial_chunk_ms)) {
+            current_ = i;
+        }
+    }
+}
+
+ChunkSizeController::Profile ChunkSizeController::Current() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return profiles_[current_];
+}
+
+void ChunkSizeController::Observe(double chunk_rtf, size_t queue_depth) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    observed_++;
+    avg_rtf_ = has_sample_ ? (1.0 - options_.ewma_alpha) * avg_rtf_ + options_.ewma_alpha * chunk_rtf : chunk_rtf;
+    has_sample_ = true;
+    if (++chunks_since_switch_ < options_.hold_chunks) return;
+
+    bool overloaded = avg_rtf_ > options_.grow_rtf || queue_depth > options_.grow_queue_depth;
+    bool idle = avg_rtf_ < options_.shrink_rtf && queue_depth == 0;
+    if (overloaded && current_ + 1 < profiles_.size()) {
+        current_++;
+        grows_++;
+        chunks_since_switch_ = 0;
+    } else if (idle && !overloaded && current_ > 0) {
+        current_--;
+        shrinks_++;
+        chunks_since_switch_ = 0;
+    }
+}
+
+ChunkSizeController::Stats ChunkSizeController::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.current_chunk_ms = profiles_[current_].chunk_ms;
+    stats.avg_rtf = avg_rtf_;
+    stats.observed = observed_;
+    stats.grows = grows_;
+    stats.shrinks = shrinks_;
+    return stats;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * 流式分块自适应控制器 - 按负载在几档分块配置间切换
+ *
+ * 🆕 固定600ms分块在空闲时延迟偏高、满载时吞吐不足:
+ * - 所有会话的每块RTF汇总为指数滑动平均，与共享执行器排队深度共同反映负载
+ * - 空闲 (RTF低且无排队) 时降一档，缩短首字延迟；繁忙 (RTF高或排队过深) 时升一档，提高吞吐
+ * - 每次切换后至少观察hold_chunks个分块再做下一次决定，避免来回抖动
+ * - 可选档位限定在[min_chunk_ms, max_chunk_ms]之间，由部署方设定延迟下限与上限
+ *
+ * 控制器只给出当前推荐档位；FunASR流式缓存与分块参数绑定，
+ * 由引擎在会话的语句边界 (流式缓存为空) 时采用新档位。多线程安全。
+ */
+class ChunkSizeController {
+public:
+    /**
+     * 分块档位 - 对应FunASR流式参数 (chunk_size单位为60ms帧)
+     */
+    struct Profile {
+        int chunk_ms = 600;                              // 每次送入的音频时长
+        std::array<int, 3> chunk_size = {0, 10, 5};      // [0, 分块, 前瞻]
+        int encoder_chunk_look_back = 4;                 // 编码器回看块数
+        int decoder_chunk_look_back = 1;                 // 解码器回看块数
+    };
+
+    struct Options {
+        int min_chunk_ms = 300;          // 延迟下限 (最小分块)
+        int max_chunk_ms = 960;          // 延迟上限 (最大分块)
+        int initial_chunk_ms = 600;      // 初始档位 (取可选档位中最接近的一档)
+        double shrink_rtf = 0.3;         // 平均RTF低于该值且无排队时降档
+        double grow_rtf = 0.7;           // 平均RTF高于该值时升档
+        size_t grow_queue_depth = 8;     // 执行器排队任务超过该值时升档
+        int hold_chunks = 20;            // 两次切换之间至少观察的分块数
+        double ewma_alpha = 0.1;         // RTF滑动平均系数
+    };
+
+    struct Stats {
+        int current_chunk_ms = 0;
+        double avg_rtf = 0.0;            // 当前RTF滑动平均
+        uint64_t observed = 0;           // 已观察分块数
+        uint64_t grows = 0;              // 升档次数
+        uint64_t shrinks = 0;            // 降档次数
+    };
+
+    explicit ChunkSizeController(const Options& options);
+
+    /**
+     * 全部内置档位 (按分块时长升序)
+     */
+    static const std::vector<Profile>& AllProfiles();
+
+    /**
+     * [min_chunk_ms, max_chunk_ms]内是否至少有一个内置档位 (配置校验用)
+     */
+    static bool HasProfileInRange(int min_chunk_ms, int max_chunk_ms);
+
+    /**
+     * 当前推荐档位
+     */
+    Profile Current() const;
+
+    /**
+     * 记录一个分块的RTF与当时的执行器排队深度
+     */
+    void Observe(double chunk_rtf, size_t queue_depth);
+
+    Stats GetStats() const;
+
+private:
+    std::vector<Profile> profiles_;      // 限定在[min, max]内的可选档位
+    Options options_;
+
+    mutable std::mutex mutex_;
+    size_t current_ = 0;
+    double avg_rtf_ = 0.0;
+    bool has_sample_ = false;
+    int chunks_since_switch_ = 0;
+    uint64_t observed_ = 0;
+    uint64_t grows_ = 0;
+    uint64_t shrinks_ = 0;
+};
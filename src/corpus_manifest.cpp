@@ -0,0 +1,177 @@
+#include "corpus_manifest.h"
+#include <atomic>
+#include <queue>
+#include <thread>
+
+namespace {
+const char* kManifestHeader = "# funasr manifest v1\tpath\tsize\tmtime\trate\tchannels\tbits\tduration";
+}
+
+/**
+ * 读取单个文件的元数据 (只解析头部)
+ */
+bool CorpusManifest::ReadEntry(const std::string& path, Entry& entry) {
+    std::error_code ec;
+    entry.path = path;
+    entry.file_size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    entry.mtime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+    if (ec) return false;
+    
+    std::ifstream file(path, std::ios::binary);
+    WavHeader header;
+    if (!file.is_open() || !AudioFileReader::ReadWavHeader(file, header)) {
+        return false;
+    }
+    entry.sample_rate = header.sample_rate;
+    entry.channels = header.channels;
+    entry.bits_per_sample = header.bits_per_sample;
+    entry.duration_seconds = header.DurationSeconds();
+    return true;
+}
+
+bool CorpusManifest::Build(const std::string& directory, int num_threads, const std::string& cache_path) {
+    Timer build_timer;
+    auto wav_files = AudioFileReader::ScanWavFiles(directory);
+    if (wav_files.empty()) {
+        return false;
+    }
+    
+    std::string manifest_path = cache_path.empty()
+        ? (std::filesystem::path(directory) / kDefaultFileName).string() : cache_path;
+    CorpusManifest cached;
+    bool has_cache = cached.Load(manifest_path);
+    
+    // 缓存中大小与修改时间一致的条目直接复用
+    std::vector<Entry> entries(wav_files.size());
+    std::vector<size_t> to_scan;
+    for (size_t i = 0; i < wav_files.size(); ++i) {
+        const Entry* hit = has_cache ? cached.Find(wav_files[i]) : nullptr;
+        std::error_code ec;
+        if (hit && hit->file_size == std::filesystem::file_size(wav_files[i], ec) && !ec &&
+            hit->mtime == std::filesystem::last_write_time(wav_files[i], ec).time_since_epoch().count() && !ec) {
+            entries[i] = *hit;
+        } else {
+            to_scan.push_back(i);
+        }
+    }
+    
+    // 并行读取头部
+    std::atomic<size_t> next{0};
+    std::atomic<int> failed{0};
+    auto worker = [&]() {
+        for (size_t k = next++; k < to_scan.size(); k = next++) {
+            size_t i = to_scan[k];
+            if (!ReadEntry(wav_files[i], entries[i])) {
+                entries[i].path = wav_files[i];
+                failed++;
+            }
+        }
+    };
+    int threads = std::max(1, std::min(num_threads, static_cast<int>(to_scan.size())));
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers) t.join();
+    
+    entries_ = std::move(entries);
+    RebuildIndex();
+    
+    if (!to_scan.empty() && !Save(manifest_path)) {
+        Logger::Warn("清单缓存写入失败 (不影响本次运行): {}", manifest_path);
+    }
+    
+    std::ostringstream build_log;
+    build_log << "语料清单构建完成: " << entries_.size() << "个文件 (复用缓存"
+              << entries_.size() - to_scan.size() << "个, 读取头部" << to_scan.size() << "个, 失败"
+              << failed.load() << "个), 总时长: " << std::fixed << std::setprecision(2)
+              << TotalDurationSeconds() / 3600.0 << "小时, 耗时: " << std::setprecision(1)
+              << build_timer.ElapsedMs() << "ms";
+    Logger::Info(build_log.str());
+    return true;
+}
+
+bool CorpusManifest::Load(const std::string& path) {
+    std::ifstream input(path);
+    if (!input.is_open()) return false;
+    
+    std::string line;
+    if (!std::getline(input, line) || line != kManifestHeader) {
+        return false;
+    }
+    std::vector<Entry> entries;
+    while (std::getline(input, line)) {
+        std::istringstream fields(line);
+        Entry entry;
+        if (!std::getline(fields, entry.path, '\t') ||
+            !(fields >> entry.file_size >> entry.mtime >> entry.sample_rate >> entry.channels
+                     >> entry.bits_per_sample >> entry.duration_seconds)) {
+            return false;
+        }
+        entries.push_back(std::move(entry));
+    }
+    entries_ = std::move(entries);
+    RebuildIndex();
+    return true;
+}
+
+bool CorpusManifest::Save(const std::string& path) const {
+    // 先写临时文件再改名，避免并发运行读到半个清单
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream output(temp_path, std::ios::trunc);
+        if (!output.is_open()) return false;
+        output << kManifestHeader << "\n";
+        output << std::setprecision(17);
+        for (const auto& entry : entries_) {
+            output << entry.path << '\t' << entry.file_size << '\t' << entry.mtime << '\t'
+                   << entry.sample_rate << '\t' << entry.channels << '\t' << entry.bits_per_sample << '\t'
+                   << entry.duration_seconds << "\n";
+        }
+        if (!output) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    return !ec;
+}
+
+const CorpusManifest::Entry* CorpusManifest::Find(const std::string& path) const {
+    auto it = index_.find(path);
+    return it == index_.end() ? nullptr : &entries_[it->second];
+}
+
+double CorpusManifest::TotalDurationSeconds() const {
+    double total = 0.0;
+    for (const auto& entry : entries_) total += entry.duration_seconds;
+    return total;
+}
+
+void CorpusManifest::RebuildIndex() {
+    index_.clear();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        index_[entries_[i].path] = i;
+    }
+}
+
+std::vector<std::vector<size_t>> CorpusManifest::BalanceByDuration(const std::vector<double>& durations, int num_bins) {
+    num_bins = std::max(1, num_bins);
+    std::vector<std::vector<size_t>> bins(num_bins);
+    
+    std::vector<size_t> order(durations.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&durations](size_t a, size_t b) {
+        return durations[a] > durations[b];
+    });
+    
+    // 小顶堆: (累计时长, 工作者下标)
+    using Load = std::pair<double, int>;
+    std::priority_queue<Load, std::vector<Load>, std::greater<Load>> loads;
+    for (int b = 0; b < num_bins; ++b) loads.emplace(0.0, b);
+    for (size_t index : order) {
+        Load lightest = loads.top();
+        loads.pop();
+        bins[lightest.second].push_back(index);
+        loads.emplace(lightest.first + durations[index], lightest.second);
+    }
+    return bins;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils.h"
+
+/**
+ * 语料清单 - 预先记录每个文件的时长、采样率与声道数
+ * 
+ * 🆕 只读取 WAV 头部并行构建，结果缓存到磁盘 (TSV)；
+ * 再次构建时大小与修改时间未变的文件直接复用缓存条目。
+ * 测试框架和批处理任务据此按音频总时长而非文件个数分配工作。
+ */
+class CorpusManifest {
+public:
+    struct Entry {
+        std::string path;
+        uint64_t file_size = 0;
+        int64_t mtime = 0;                // 修改时间 (文件系统时钟计数)
+        int sample_rate = 0;
+        int channels = 0;
+        int bits_per_sample = 0;
+        double duration_seconds = 0.0;
+        
+        bool IsUsable() const { return bits_per_sample == 16 && duration_seconds > 0.0; }
+    };
+    
+    static constexpr const char* kDefaultFileName = ".funasr_manifest.tsv";
+    
+    /**
+     * 扫描目录构建清单
+     * @param directory 音频目录
+     * @param num_threads 并行读取头部的线程数
+     * @param cache_path 清单缓存文件 (空表示目录下的默认文件名)
+     */
+    bool Build(const std::string& directory, int num_threads, const std::string& cache_path = "");
+    
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+    
+    const std::vector<Entry>& Entries() const { return entries_; }
+    const Entry* Find(const std::string& path) const;
+    double TotalDurationSeconds() const;
+    
+    /**
+     * 按时长均衡分配 - 最长优先贪心 (LPT)
+     * 
+     * 每次把剩余最长的任务交给当前累计时长最小的工作者，
+     * 返回每个工作者分到的下标列表 (不会丢弃任何任务)。
+     */
+    static std::vector<std::vector<size_t>> BalanceByDuration(const std::vector<double>& durations, int num_bins);
+
+private:
+    static bool ReadEntry(const std::string& path, Entry& entry);
+    void RebuildIndex();
+    
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, size_t> index_;
+};
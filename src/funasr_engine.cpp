@@ -4,6 +4,7 @@
 #include <future>
 #include <sstream>
 #include <iomanip>
+#include <deque>
 
 // Linux系统相关头文件 (CPU版本新增)
 #ifdef __linux__
@@ -11,12 +12,38 @@
 #include <unistd.h>        // 系统信息
 #endif
 
+/**
+ * 本线程累计的GIL等待毫秒数 (实时节奏压测据此从单块耗时中拆出GIL争用)
+ */
+thread_local double t_gil_wait_ms = 0.0;
+
+/**
+ * 获取GIL并把等待时间记入gil_wait阶段 (成员按声明顺序构造: 先检查与计时，再获取GIL)
+ * 本线程已持有GIL时 (嵌套获取) 不会等待，不记录，避免大量近0样本稀释分布
+ */
+struct TimedGilAcquire {
+    const bool nested;
+    StageProfiler::Span wait;
+    py::gil_scoped_acquire gil;
+    explicit TimedGilAcquire(StageProfiler& profiler)
+        : nested(PyGILState_Check() != 0), wait(profiler, StageProfiler::Stage::kGilWait) {
+        if (nested) {
+            wait.Cancel();
+        } else {
+            t_gil_wait_ms += wait.End();
+        }
+    }
+};
+
 /**
  * 构造函数 - CPU版本适配
  * 
  * 🔄 主要变化: 日志输出适配CPU模式
  */
 FunASREngine::FunASREngine(const Config& config) : config_(config) {
+    if (!config_.trace_output_path.empty()) {
+        TraceRecorder::Instance().Enable(static_cast<size_t>(std::max(1, config_.trace_buffer_events)));
+    }
     // 修复日志格式化问题 - 使用字符串拼接替代模板格式化
     std::ostringstream log_msg;
     log_msg << "创建FunASR CPU引擎，设备: " << config_.device 
@@ -35,6 +62,26 @@ FunASREngine::~FunASREngine() {
     if (test_thread_.joinable()) {
         test_thread_.join();
     }
+    // 指标服务读取各组件状态，先于组件停止
+    metrics_server_.reset();
+    // 先执行完排队任务 (任务需要获取GIL)，再重新获取GIL；流水线按上游到下游依次排空
+    vad_stage_.reset();
+    asr_stage_.reset();
+    punc_stage_.reset();
+    session_manager_.reset();
+    refinement_queue_.reset();
+    executor_.reset();
+    // 重新获取GIL，保证模型对象在解释器销毁前安全释放
+    gil_release_.reset();
+    if (!config_.trace_output_path.empty()) {
+        auto trace_stats = TraceRecorder::Instance().GetStats();
+        if (TraceRecorder::Instance().WriteChromeTrace(config_.trace_output_path)) {
+            std::ostringstream trace_log;
+            trace_log << "追踪已写入: " << config_.trace_output_path << " (" << trace_stats.recorded << "个事件, "
+                      << trace_stats.threads << "个线程, 缓冲满丢弃" << trace_stats.dropped << "个)";
+            Logger::Info(trace_log.str());
+        }
+    }
     Logger::Info("FunASR CPU引擎已销毁");
 }
 
@@ -52,6 +99,45 @@ bool FunASREngine::Initialize() {
     Timer init_timer;
     
     try {
+        // 0. 解码音频缓存预算与共享执行器
+        AudioCache::Instance().SetCapacityBytes(static_cast<size_t>(config_.audio_cache_mb) * 1024 * 1024);
+        int executor_threads = config_.executor_threads > 0 ? config_.executor_threads : config_.cpu_threads;
+        executor_ = std::make_unique<TaskExecutor>(executor_threads,
+                                                   static_cast<size_t>(config_.executor_queue_size),
+                                                   config_.latency_cpu_share / 100.0,
+                                                   config_.throughput_aging_ms);
+        std::ostringstream executor_log;
+        executor_log << "共享执行器: " << executor_->NumThreads() << "个线程, 队列上限" << config_.executor_queue_size
+                     << ", 低延迟份额" << config_.latency_cpu_share << "%, 吞吐任务最长排队"
+                     << config_.throughput_aging_ms << "ms";
+        Logger::Info(executor_log.str());
+        refinement_queue_ = std::make_unique<RefinementQueue>(
+            *executor_, config_.refinement_workers, static_cast<size_t>(config_.refinement_queue_size),
+            [this](const float* audio, size_t size) { return RefineSegment(audio, size); });
+        const size_t buffer_samples =
+            16ULL * (1000ULL * std::max(1, config_.session_buffer_seconds) + std::max(0, config_.two_pass_preroll_ms));
+        session_manager_ = std::make_unique<SessionManager<TwoPassSession>>(
+            static_cast<size_t>(config_.max_concurrent_sessions),
+            static_cast<size_t>(std::max(0, config_.session_pool_size)),
+            std::chrono::milliseconds(config_.session_idle_timeout_ms),
+            [buffer_samples]() {
+                auto session = std::make_unique<TwoPassSession>();
+                session->Reserve(buffer_samples);
+                return session;
+            },
+            [](TwoPassSession& session) { session.Recycle(); });
+        if (config_.enable_adaptive_chunking) {
+            ChunkSizeController::Options chunk_options;
+            chunk_options.min_chunk_ms = config_.chunk_min_ms;
+            chunk_options.max_chunk_ms = config_.chunk_max_ms;
+            chunk_options.grow_queue_depth = static_cast<size_t>(executor_->NumThreads());
+            chunk_controller_ = std::make_unique<ChunkSizeController>(chunk_options);
+            std::ostringstream chunk_log;
+            chunk_log << "自适应分块: " << config_.chunk_min_ms << "-" << config_.chunk_max_ms
+                      << "ms, 初始" << chunk_controller_->Current().chunk_ms << "ms";
+            Logger::Info(chunk_log.str());
+        }
+        
         // 1. CPU性能优化 (🆕 CPU版本新增)
         if (config_.enable_cpu_optimization) {
             OptimizeCPUPerformance();
@@ -94,6 +180,11 @@ bool FunASREngine::Initialize() {
             return false;
         }
         
+        streaming_generate_ = streaming_model_.attr("generate");
+        offline_generate_ = offline_model_.attr("generate");
+        vad_generate_ = vad_model_.attr("generate");
+        punc_generate_ = punc_model_.attr("generate");
+        
         // 4. 检查CPU资源状态 (🔄 替代GPU状态检查)
         double cpu_memory = GetCPUMemoryUsage();
         std::ostringstream memory_log;
@@ -101,17 +192,48 @@ bool FunASREngine::Initialize() {
         Logger::Info(memory_log.str());
         
         // 5. 加载测试音频文件
-        if (!LoadTestAudioFiles()) {
+        if (config_.load_test_audio && !LoadTestAudioFiles()) {
             Logger::Error("加载测试音频文件失败");
             return false;
         }
         
-        // 6. 初始化性能指标
+        // 6. 流水线阶段 (下游先创建，上游处理函数直接推送到下游)
+        if (config_.enable_pipeline) {
+            const size_t queue_size = static_cast<size_t>(config_.pipeline_queue_size);
+            punc_stage_ = std::make_unique<PipelineStage<PipelineRequestPtr>>(
+                "punc", config_.pipeline_punc_workers, queue_size, 1,
+                [this](std::vector<PipelineRequestPtr>& batch) { PipelinePuncStage(batch); });
+            asr_stage_ = std::make_unique<PipelineStage<PipelineRequestPtr>>(
+                "asr", config_.pipeline_asr_workers, queue_size, static_cast<size_t>(config_.pipeline_max_batch),
+                [this](std::vector<PipelineRequestPtr>& batch) { PipelineASRStage(batch); });
+            vad_stage_ = std::make_unique<PipelineStage<PipelineRequestPtr>>(
+                "vad", config_.pipeline_vad_workers, queue_size, 1,
+                [this](std::vector<PipelineRequestPtr>& batch) { PipelineVADStage(batch); });
+            std::ostringstream pipeline_log;
+            pipeline_log << "识别流水线: VAD " << config_.pipeline_vad_workers << "线程 → ASR "
+                         << config_.pipeline_asr_workers << "线程 (批≤" << config_.pipeline_max_batch << ") → 标点 "
+                         << config_.pipeline_punc_workers << "线程, 每阶段队列上限" << queue_size;
+            Logger::Info(pipeline_log.str());
+        }
+        
+        // 7. 初始化性能指标
         current_metrics_.gpu_memory_gb = cpu_memory;  // 复用字段存储CPU内存
         current_metrics_.test_files_count = test_audio_files_.size();
         
         initialized_ = true;
         
+        // 🆕 指标HTTP服务: 抓取时只读取分片/原子快照，不与识别线程争锁 (启动失败不影响识别)
+        if (config_.metrics_port > 0) {
+            metrics_server_ = std::make_unique<MetricsServer>(
+                config_.metrics_port, [this]() { return FormatPrometheusMetrics(GetPerformanceMetrics()); });
+            if (!metrics_server_->Start()) {
+                metrics_server_.reset();
+            }
+        }
+        
+        // 8. 释放主线程GIL，后续Python调用在各自线程中获取
+        gil_release_ = std::make_unique<py::gil_scoped_release>();
+        
         // 修复日志格式化 - 使用ostringstream
         std::ostringstream completion_log;
         completion_log << "FunASR CPU引擎初始化完成，耗时: " 
@@ -293,26 +415,13 @@ std::vector<float> FunASREngine::ResampleAudio(const std::vector<float>& audio_d
     }
     
     // 简单线性插值重采样
-    double ratio = static_cast<double>(to_rate) / from_rate;
-    size_t new_size = static_cast<size_t>(audio_data.size() * ratio);
-    std::vector<float> resampled(new_size);
+    StageProfiler::Span span(stage_profiler_, StageProfiler::Stage::kResample);
+    std::vector<float> resampled = AudioFileReader::Resample(audio_data, from_rate, to_rate);
+    span.End();
     
-    for (size_t i = 0; i < new_size; ++i) {
-        double src_index = i / ratio;
-        size_t idx = static_cast<size_t>(src_index);
-        
-        if (idx + 1 < audio_data.size()) {
-            double frac = src_index - idx;
-            resampled[i] = audio_data[idx] * (1.0 - frac) + audio_data[idx + 1] * frac;
-        } else {
-            resampled[i] = audio_data.back();
-        }
-    }
-    
-    std::ostringstream resample_log;
-    resample_log << "音频重采样完成: " << from_rate << "Hz → " << to_rate << "Hz, "
-                 << "样本数: " << audio_data.size() << " → " << new_size;
-    Logger::Info(resample_log.str());
+    // 分块转写时每个块都会重采样，只在调试级别输出
+    Logger::Debug("音频重采样完成: {}Hz → {}Hz, 样本数: {} → {}",
+                  from_rate, to_rate, audio_data.size(), resampled.size());
     
     return resampled;
 }
@@ -329,7 +438,8 @@ std::vector<float> FunASREngine::ResampleAudio(const std::vector<float>& audio_d
 FunASREngine::RecognitionResult FunASREngine::OfflineRecognize(
     const std::vector<float>& audio_input,
     bool enable_vad,
-    bool enable_punctuation) {
+    bool enable_punctuation,
+    int sample_rate) {
     
     RecognitionResult result;
     if (!initialized_) {
@@ -337,66 +447,44 @@ FunASREngine::RecognitionResult FunASREngine::OfflineRecognize(
         return result;
     }
     
+    TraceRecorder::Scope trace("request", "offline_recognize");
     try {
         Timer total_timer;
         
-        // 🆕 音频预处理 - 重采样支持
-        std::vector<float> audio_data = audio_input;
-        if (config_.enable_audio_resampling && audio_data.size() > 0) {
-            // 假设输入可能是24kHz (基于你的日志)，重采样到16kHz
-            // 实际项目中应该从AudioFileReader获取真实采样率
-            double input_duration = audio_data.size() / 24000.0; // 假设24kHz
-            if (input_duration > 0) {
-                audio_data = ResampleAudio(audio_input, 24000, 16000);
-            }
+        // 🆕 音频预处理 - 重采样支持 (无需重采样时直接引用输入，避免整段拷贝)
+        std::vector<float> resampled_audio;
+        const std::vector<float>* audio_ptr = &audio_input;
+        if (config_.enable_audio_resampling && !audio_input.empty() && sample_rate != 16000) {
+            resampled_audio = ResampleAudio(audio_input, sample_rate, 16000);
+            audio_ptr = &resampled_audio;
         }
+        const std::vector<float>& audio_data = *audio_ptr;
         
         std::string final_text;
         
-        // VAD分段处理 - 增强错误处理
-        enable_vad = false;
-        if (enable_vad && audio_data.size() > 16000 * 5) { // 大于5秒启用VAD
-            Logger::Info("长音频检测，启用VAD分段处理 (CPU模式)");
+        // VAD分段处理 - 语音段并行识别，按时间轴顺序合并
+        const size_t min_vad_samples = static_cast<size_t>(config_.long_audio_min_seconds * 16000);
+        if (enable_vad && audio_data.size() > min_vad_samples) {
+            Logger::Info("长音频检测，启用VAD分段并行处理 (CPU模式)");
             
             try {
-                std::map<std::string, py::object> vad_cache;
-                auto vad_result = DetectVoiceActivity(audio_data, vad_cache);
+                VADResult vad_result;
+                {
+                    TimedGilAcquire gil(stage_profiler_);
+                    PyModelCache vad_cache;
+                    vad_result = DetectVoiceActivity(audio_data, vad_cache);
+                }
                 
                 if (vad_result.HasValidSegments()) {
                     std::ostringstream vad_log;
                     vad_log << "VAD检测到" << vad_result.segments.size() << "个语音段";
                     Logger::Info(vad_log.str());
                     
-                    // 对每个语音段进行ASR识别
-                    std::vector<std::string> segment_texts;
-                    for (const auto& segment : vad_result.segments) {
-                        int start_sample = (segment.first * 16000) / 1000;
-                        int end_sample = (segment.second * 16000) / 1000;
-                        
-                        if (start_sample >= 0 && end_sample <= static_cast<int>(audio_data.size()) && 
-                            end_sample > start_sample) {
-                            
-                            std::vector<float> segment_audio(
-                                audio_data.begin() + start_sample,
-                                audio_data.begin() + end_sample
-                            );
-                            
-                            // CPU ASR识别单个段
-                            py::array_t<float> audio_array = VectorToNumpy(segment_audio);
-                            py::dict asr_kwargs;
-                            asr_kwargs["input"] = audio_array;
-                            
-                            py::object asr_result = offline_model_.attr("generate")(**asr_kwargs);
-                            auto parsed_result = ParseRecognitionResult(asr_result, 0);
-                            
-                            if (!parsed_result.text.empty()) {
-                                segment_texts.push_back(parsed_result.text);
-                            }
-                        }
-                    }
+                    auto segment_texts = RecognizeSegmentsParallel(audio_data, vad_result.segments);
                     
-                    // 合并所有段的文本
+                    // 按时间轴顺序合并所有段的文本
                     for (const auto& text : segment_texts) {
+                        if (text.empty()) continue;
                         if (!final_text.empty()) final_text += " ";
                         final_text += text;
                     }
@@ -414,11 +502,14 @@ FunASREngine::RecognitionResult FunASREngine::OfflineRecognize(
         // 完整音频识别 (CPU)
         if (!enable_vad || final_text.empty()) {
             try {
+                TimedGilAcquire gil(stage_profiler_);
                 py::array_t<float> audio_array = VectorToNumpy(audio_data);
                 py::dict asr_kwargs;
                 asr_kwargs["input"] = audio_array;
                 
-                py::object asr_result = offline_model_.attr("generate")(**asr_kwargs);
+                StageProfiler::Span generate_span(stage_profiler_, StageProfiler::Stage::kOfflineGenerate);
+                py::object asr_result = offline_generate_(**asr_kwargs);
+                generate_span.End();
                 auto parsed_result = ParseRecognitionResult(asr_result, 0);
                 final_text = parsed_result.text;
             } catch (const std::exception& e) {
@@ -428,10 +519,11 @@ FunASREngine::RecognitionResult FunASREngine::OfflineRecognize(
             }
         }
         
-        // 标点符号恢复 (CPU)
+        // 标点符号恢复 (CPU) - 分段合并后统一处理
         if (enable_punctuation && !final_text.empty()) {
             try {
-                std::map<std::string, py::object> punc_cache;
+                TimedGilAcquire gil(stage_profiler_);
+                PyModelCache punc_cache;
                 final_text = AddPunctuation(final_text, punc_cache);
             } catch (const std::exception& e) {
                 std::string warn_msg = "标点符号处理异常: " + std::string(e.what());
@@ -445,15 +537,15 @@ FunASREngine::RecognitionResult FunASREngine::OfflineRecognize(
         result.inference_time_ms = total_timer.ElapsedMs();
         
         // 更新性能指标
-        {
-            std::lock_guard<std::mutex> lock(metrics_mutex_);
-            current_metrics_.total_requests++;
-            if (!result.IsEmpty()) {
-                current_metrics_.success_requests++;
-                double audio_duration_s = audio_data.size() / 16000.0;
-                current_metrics_.offline_rtf = result.inference_time_ms / (audio_duration_s * 1000.0);
-                current_metrics_.total_audio_processed_hours += audio_duration_s / 3600.0;
-            }
+        live_metrics_.total_requests.Add();
+        live_metrics_.offline_latency.Record(result.inference_time_ms);
+        live_metrics_.window.Record(RollingWindow::Mode::kOffline, result.inference_time_ms, audio_data.size() / 16000.0,
+                                    !result.IsEmpty());
+        if (!result.IsEmpty()) {
+            live_metrics_.success_requests.Add();
+            double audio_duration_s = audio_data.size() / 16000.0;
+            live_metrics_.offline_rtf.store(result.inference_time_ms / (audio_duration_s * 1000.0), std::memory_order_relaxed);
+            live_metrics_.AddAudio(audio_duration_s);
         }
         
         // 修复日志格式化
@@ -465,12 +557,544 @@ FunASREngine::RecognitionResult FunASREngine::OfflineRecognize(
     } catch (const std::exception& e) {
         std::string error_msg = "CPU离线识别异常: " + std::string(e.what());
         Logger::Error(error_msg);
-        current_metrics_.total_requests++;
+        live_metrics_.total_requests.Add();
+        live_metrics_.window.RecordError();
     }
     
     return result;
 }
 
+/**
+ * 长音频VAD分段并行识别
+ * 
+ * 🆕 各工作线程通过原子下标领取语音段，模型推理期间PyTorch会释放GIL，
+ * 多个语音段的计算因此可以在多核上重叠执行。
+ */
+std::vector<std::string> FunASREngine::RecognizeSegmentsParallel(
+    const std::vector<float>& audio_data,
+    const std::vector<std::pair<int64_t, int64_t>>& segments) {
+    
+    std::vector<std::string> segment_texts(segments.size());
+    if (segments.empty()) {
+        return segment_texts;
+    }
+    
+    const int num_workers = std::max(1, std::min(config_.long_audio_workers,
+                                                 static_cast<int>(segments.size())));
+    std::atomic<size_t> next_segment{0};
+    Timer parallel_timer;
+    
+    auto worker = [this, &audio_data, &segments, &segment_texts, &next_segment]() {
+        for (size_t idx = next_segment++; idx < segments.size(); idx = next_segment++) {
+            const auto& segment = segments[idx];
+            int64_t start_sample = (segment.first * 16000) / 1000;
+            int64_t end_sample = (segment.second * 16000) / 1000;
+            end_sample = std::min<int64_t>(end_sample, static_cast<int64_t>(audio_data.size()));
+            
+            if (start_sample < 0 || end_sample <= start_sample) {
+                continue;
+            }
+            segment_texts[idx] = RecognizeSegment(audio_data.data() + start_sample,
+                                                  static_cast<size_t>(end_sample - start_sample));
+        }
+    };
+    
+    std::vector<std::future<void>> futures;
+    for (int i = 1; i < num_workers; ++i) {
+        futures.emplace_back(executor_->Submit(TaskExecutor::TaskClass::kThroughput, worker));
+    }
+    worker();  // 调用线程同样参与识别
+    for (auto& future : futures) executor_->Wait(future);
+    
+    std::ostringstream parallel_log;
+    parallel_log << "VAD分段并行识别完成: " << segments.size() << "个语音段, "
+                 << num_workers << "个线程, 耗时: "
+                 << std::fixed << std::setprecision(1) << parallel_timer.ElapsedMs() << "ms";
+    Logger::Info(parallel_log.str());
+    
+    return segment_texts;
+}
+
+std::string FunASREngine::RecognizeSegment(const float* data, size_t size) {
+    try {
+        TimedGilAcquire gil(stage_profiler_);
+        py::dict asr_kwargs;
+        asr_kwargs["input"] = SegmentToNumpy(data, size);
+        
+        StageProfiler::Span generate_span(stage_profiler_, StageProfiler::Stage::kOfflineGenerate);
+        py::object asr_result = offline_generate_(**asr_kwargs);
+        generate_span.End();
+        return ParseRecognitionResult(asr_result, 0).text;
+    } catch (const std::exception& e) {
+        std::string error_msg = "语音段识别异常: " + std::string(e.what());
+        Logger::Error(error_msg);
+    }
+    return "";
+}
+
+/**
+ * 2Pass离线精化 - 直接识别会话缓冲中的语音段 (无需拷贝成vector)，随后添加标点
+ */
+std::string FunASREngine::RefineSegment(const float* data, size_t size) {
+    TraceRecorder::Scope trace("request", "refine_segment");
+    Timer refine_timer;
+    std::string text = RecognizeSegment(data, size);
+    if (!text.empty()) {
+        try {
+            TimedGilAcquire gil(stage_profiler_);
+            PyModelCache punc_cache;
+            text = AddPunctuation(text, punc_cache);
+        } catch (const std::exception& e) {
+            Logger::Warn("标点符号处理异常: {}", e.what());
+        }
+    }
+    
+    const double refine_ms = refine_timer.ElapsedMs();
+    live_metrics_.total_requests.Add();
+    live_metrics_.offline_latency.Record(refine_ms);
+    // 精化属于所在2Pass请求，滑动窗口只按顶层请求记录 (由TwoPassRecognize计入)
+    if (!text.empty() && size > 0) {
+        live_metrics_.success_requests.Add();
+        double audio_duration_s = size / 16000.0;
+        live_metrics_.offline_rtf.store(refine_ms / (audio_duration_s * 1000.0), std::memory_order_relaxed);
+        live_metrics_.AddAudio(audio_duration_s);
+    }
+    return text;
+}
+
+std::future<FunASREngine::RecognitionResult> FunASREngine::SubmitPipelined(
+    std::vector<float> audio_data, int sample_rate) {
+    auto request = std::make_shared<PipelineRequest>();
+    request->audio = std::move(audio_data);
+    request->sample_rate = sample_rate;
+    auto future = request->promise.get_future();
+    
+    if (!initialized_ || !vad_stage_) {
+        Logger::Error("流水线未启用 (需开启enable_pipeline并初始化引擎)");
+        request->promise.set_value(RecognitionResult{});
+        return future;
+    }
+    vad_stage_->Push(std::move(request));
+    return future;
+}
+
+void FunASREngine::PipelineVADStage(std::vector<PipelineRequestPtr>& batch) {
+    const size_t min_vad_samples = static_cast<size_t>(config_.long_audio_min_seconds * 16000);
+    for (auto& request : batch) {
+        try {
+            if (config_.enable_audio_resampling && !request->audio.empty() && request->sample_rate != 16000) {
+                request->audio = ResampleAudio(request->audio, request->sample_rate, 16000);
+                request->sample_rate = 16000;
+            }
+            request->audio_seconds = request->audio.size() / static_cast<double>(request->sample_rate);
+            if (request->audio.size() > min_vad_samples) {
+                TimedGilAcquire gil(stage_profiler_);
+                PyModelCache vad_cache;
+                request->segments = DetectVoiceActivity(request->audio, vad_cache).segments;
+            }
+        } catch (const std::exception& e) {
+            std::string error_msg = "流水线VAD异常，回退到完整音频识别: " + std::string(e.what());
+            Logger::Error(error_msg);
+            request->segments.clear();
+        }
+        // 短音频或VAD无结果时整段识别
+        if (request->segments.empty() && !request->audio.empty()) {
+            request->segments.emplace_back(0, static_cast<int64_t>((request->audio.size() * 1000 + 15999) / 16000));
+        }
+        asr_stage_->Push(std::move(request));
+    }
+}
+
+void FunASREngine::PipelineASRStage(std::vector<PipelineRequestPtr>& batch) {
+    // 展开本批所有请求的语音段，按max_batch分组批量推理
+    struct SegmentRef {
+        size_t request_index;
+        const float* data;
+        size_t size;
+    };
+    std::vector<SegmentRef> refs;
+    for (size_t r = 0; r < batch.size(); ++r) {
+        const auto& audio = batch[r]->audio;
+        for (const auto& segment : batch[r]->segments) {
+            int64_t start_sample = segment.first * 16;
+            int64_t end_sample = std::min<int64_t>(segment.second * 16, static_cast<int64_t>(audio.size()));
+            if (start_sample < 0 || end_sample <= start_sample) continue;
+            refs.push_back({r, audio.data() + start_sample, static_cast<size_t>(end_sample - start_sample)});
+        }
+    }
+    
+    std::vector<std::string> texts(refs.size());
+    const size_t max_batch = static_cast<size_t>(std::max(1, config_.pipeline_max_batch));
+    for (size_t begin = 0; begin < refs.size(); begin += max_batch) {
+        size_t end = std::min(begin + max_batch, refs.size());
+        try {
+            TimedGilAcquire gil(stage_profiler_);
+            py::list inputs;
+            for (size_t i = begin; i < end; ++i) {
+                inputs.append(SegmentToNumpy(refs[i].data, refs[i].size));
+            }
+            py::dict asr_kwargs;
+            asr_kwargs["input"] = inputs;
+            asr_kwargs["batch_size"] = static_cast<int>(end - begin);
+            
+            StageProfiler::Span generate_span(stage_profiler_, StageProfiler::Stage::kOfflineGenerate);
+            py::object asr_result = offline_generate_(**asr_kwargs);
+            generate_span.End();
+            if (py::isinstance<py::list>(asr_result)) {
+                py::list result_list = asr_result;
+                for (size_t i = begin; i < end && i - begin < result_list.size(); ++i) {
+                    py::dict item = result_list[i - begin];
+                    if (item.contains("text")) {
+                        texts[i] = item["text"].cast<std::string>();
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            // 单个语音段出错会使整批失败，逐段重试，只让出错的语音段为空
+            std::string error_msg = "流水线ASR批处理异常: " + std::string(e.what());
+            if (end - begin > 1) {
+                Logger::Warn(error_msg + "，逐段重试");
+                for (size_t i = begin; i < end; ++i) {
+                    texts[i] = RecognizeSegment(refs[i].data, refs[i].size);
+                }
+            } else {
+                Logger::Error(error_msg);
+            }
+        }
+    }
+    
+    // 按时间轴顺序合并各请求的语音段文本，释放音频后交给标点阶段
+    for (size_t i = 0; i < refs.size(); ++i) {
+        if (texts[i].empty()) continue;
+        auto& text = batch[refs[i].request_index]->text;
+        if (!text.empty()) text += " ";
+        text += texts[i];
+    }
+    for (auto& request : batch) {
+        request->audio.clear();
+        request->audio.shrink_to_fit();
+        punc_stage_->Push(std::move(request));
+    }
+}
+
+void FunASREngine::PipelinePuncStage(std::vector<PipelineRequestPtr>& batch) {
+    for (auto& request : batch) {
+        RecognitionResult result;
+        if (!request->text.empty()) {
+            try {
+                TimedGilAcquire gil(stage_profiler_);
+                PyModelCache punc_cache;
+                result.text = AddPunctuation(request->text, punc_cache);
+            } catch (const std::exception& e) {
+                std::string warn_msg = "流水线标点处理异常: " + std::string(e.what());
+                Logger::Warn(warn_msg);
+                result.text = request->text;
+            }
+        }
+        result.is_final = true;
+        result.is_offline_result = true;
+        result.inference_time_ms = request->timer.ElapsedMs();
+        
+        live_metrics_.total_requests.Add();
+        live_metrics_.offline_latency.Record(result.inference_time_ms);
+        live_metrics_.window.Record(RollingWindow::Mode::kOffline, result.inference_time_ms, request->audio_seconds,
+                                    !result.IsEmpty());
+        if (!result.IsEmpty()) {
+            live_metrics_.success_requests.Add();
+            if (request->audio_seconds > 0.0) {
+                live_metrics_.offline_rtf.store(result.inference_time_ms / (request->audio_seconds * 1000.0),
+                                                std::memory_order_relaxed);
+                live_metrics_.AddAudio(request->audio_seconds);
+            }
+        }
+        request->promise.set_value(std::move(result));
+    }
+}
+
+/**
+ * 长音频文件分块转写 - 有界内存
+ * 
+ * 🆕 pending缓冲只保存尚未定稿的音频 (当前语音段 + 一个块的预留)，
+ * 语音段定稿后提交到后台识别并立即丢弃；在途识别数不超过long_audio_workers。
+ */
+FunASREngine::RecognitionResult FunASREngine::RecognizeWavFileStreaming(
+    const std::string& file_path,
+    const std::function<void(const RecognitionResult&)>& on_segment,
+    bool enable_punctuation,
+    bool parallel_segments) {
+    
+    RecognitionResult result;
+    if (!initialized_) {
+        Logger::Error("引擎未初始化");
+        return result;
+    }
+    
+    WavStreamReader reader;
+    if (!reader.Open(file_path)) {
+        return result;
+    }
+    
+    try {
+        Timer total_timer;
+        const int source_rate = reader.Header().sample_rate;
+        const int block_ms = std::max(100, config_.long_audio_block_ms);
+        const size_t block_frames = static_cast<size_t>(source_rate) * block_ms / 1000;
+        const int64_t block_samples = 16000LL * block_ms / 1000;
+        const int max_segment_ms = 30000;
+        const int64_t max_pending_samples = 16000LL * max_segment_ms / 1000 + block_samples;
+        const size_t max_in_flight = parallel_segments ? static_cast<size_t>(std::max(1, config_.long_audio_workers)) : 1;
+        
+        std::ostringstream start_log;
+        start_log << "开始分块转写: " << file_path << ", 时长: " << std::fixed << std::setprecision(1)
+                  << reader.Header().DurationSeconds() << "秒, 分块: " << block_ms << "ms";
+        Logger::Info(start_log.str());
+        
+        // 会话对象持有VAD/标点缓存，析构时在GIL保护下释放
+        TwoPassSession session;
+        std::vector<float> pending;           // 未定稿音频 (16kHz)
+        int64_t pending_start = 0;            // pending首样本的绝对下标
+        int64_t open_segment_start_ms = -1;   // 当前未结束语音段的起点
+        std::deque<std::future<std::string>> in_flight;
+        int segment_count = 0;
+        
+        auto drop_until = [&pending, &pending_start](int64_t sample) {
+            int64_t count = std::min<int64_t>(sample - pending_start, static_cast<int64_t>(pending.size()));
+            if (count <= 0) return;
+            pending.erase(pending.begin(), pending.begin() + count);
+            pending_start += count;
+        };
+        
+        auto emit_front = [&]() {
+            std::string text = executor_->Wait(in_flight.front());
+            in_flight.pop_front();
+            if (text.empty()) return;
+            if (enable_punctuation) {
+                text = AddPunctuation(text, session.punc_cache);
+            }
+            if (!result.text.empty() && !enable_punctuation) result.text += " ";
+            result.text += text;
+            segment_count++;
+            if (on_segment) {
+                RecognitionResult segment_result;
+                segment_result.text = text;
+                segment_result.is_final = true;
+                segment_result.is_offline_result = true;
+                on_segment(segment_result);
+            }
+        };
+        
+        auto cut_segment = [&](int64_t start_ms, int64_t end_ms) {
+            int64_t start = std::max<int64_t>(start_ms * 16, pending_start);
+            int64_t end = std::min<int64_t>(end_ms * 16, pending_start + static_cast<int64_t>(pending.size()));
+            if (end > start) {
+                if (parallel_segments) {
+                    auto segment = std::make_shared<std::vector<float>>(
+                        pending.begin() + (start - pending_start), pending.begin() + (end - pending_start));
+                    in_flight.emplace_back(executor_->Submit(TaskExecutor::TaskClass::kThroughput, [this, segment]() {
+                        return RecognizeSegment(segment->data(), segment->size());
+                    }));
+                } else {
+                    // 直接识别pending中的区间，无需拷贝
+                    std::promise<std::string> done;
+                    done.set_value(RecognizeSegment(pending.data() + (start - pending_start), static_cast<size_t>(end - start)));
+                    in_flight.emplace_back(done.get_future());
+                }
+            }
+            drop_until(end);
+            while (in_flight.size() >= max_in_flight) emit_front();
+        };
+        
+        std::vector<float> block;
+        while (reader.Read(block_frames, block) > 0) {
+            bool is_final = reader.IsEof();
+            if (source_rate != 16000) {
+                block = ResampleAudio(block, source_rate, 16000);
+            }
+            
+            // 静音期间只保留一个块的预留，VAD起点可能落在上一块
+            if (open_segment_start_ms == -1) {
+                drop_until(pending_start + static_cast<int64_t>(pending.size()) - block_samples);
+            }
+            pending.insert(pending.end(), block.begin(), block.end());
+            
+            auto vad_result = DetectVoiceActivity(block, session.vad_cache, max_segment_ms, is_final, block_ms);
+            for (const auto& segment : vad_result.segments) {
+                if (segment.first != -1) {
+                    open_segment_start_ms = segment.first;
+                }
+                if (segment.second != -1 && open_segment_start_ms != -1) {
+                    cut_segment(open_segment_start_ms, segment.second);
+                    open_segment_start_ms = -1;
+                }
+            }
+            
+            // VAD未及时切分时强制截断，保证pending有界
+            if (open_segment_start_ms != -1 && static_cast<int64_t>(pending.size()) > max_pending_samples) {
+                int64_t now_ms = (pending_start + static_cast<int64_t>(pending.size())) / 16;
+                cut_segment(open_segment_start_ms, now_ms);
+                open_segment_start_ms = now_ms;
+            }
+        }
+        
+        if (open_segment_start_ms != -1) {
+            cut_segment(open_segment_start_ms, (pending_start + static_cast<int64_t>(pending.size())) / 16);
+        }
+        while (!in_flight.empty()) emit_front();
+        
+        result.is_final = true;
+        result.is_offline_result = true;
+        result.inference_time_ms = total_timer.ElapsedMs();
+        
+        // 头部声明的时长可能为0 (空文件或data块长度未写入)，此时不计算RTF
+        double audio_duration_s = reader.Header().DurationSeconds();
+        double rtf = audio_duration_s > 0.0 ? result.inference_time_ms / (audio_duration_s * 1000.0) : 0.0;
+        live_metrics_.total_requests.Add();
+        live_metrics_.offline_latency.Record(result.inference_time_ms);
+        live_metrics_.window.Record(RollingWindow::Mode::kOffline, result.inference_time_ms, audio_duration_s,
+                                    !result.IsEmpty());
+        if (!result.IsEmpty()) {
+            live_metrics_.success_requests.Add();
+            if (audio_duration_s > 0.0) {
+                live_metrics_.offline_rtf.store(rtf, std::memory_order_relaxed);
+            }
+            live_metrics_.AddAudio(audio_duration_s);
+        }
+        
+        std::ostringstream done_log;
+        done_log << "分块转写完成: " << segment_count << "个语音段, 耗时: "
+                 << std::fixed << std::setprecision(1) << result.inference_time_ms << "ms, RTF: "
+                 << std::setprecision(4) << rtf;
+        Logger::Info(done_log.str());
+        
+    } catch (const std::exception& e) {
+        std::string error_msg = "分块转写异常: " + std::string(e.what());
+        Logger::Error(error_msg);
+    }
+    
+    return result;
+}
+
+/**
+ * 批量转写 - 工作窃取线程池按文件调度
+ * 
+ * 🆕 文件时长来自语料清单，按LPT预分配到各线程队列，运行时空闲线程窃取剩余文件
+ */
+size_t FunASREngine::BulkTranscribe(
+    const std::string& audio_dir,
+    int num_workers,
+    const std::function<void(const std::string&, const RecognitionResult&, double)>& on_result) {
+    
+    CorpusManifest manifest;
+    if (!manifest.Build(audio_dir, config_.manifest_threads, config_.manifest_cache_path)) {
+        Logger::Error("批量转写: 无法构建语料清单 {}", audio_dir);
+        return 0;
+    }
+    
+    std::vector<const CorpusManifest::Entry*> entries;
+    std::vector<double> durations;
+    for (const auto& entry : manifest.Entries()) {
+        if (!entry.IsUsable()) continue;
+        entries.push_back(&entry);
+        durations.push_back(entry.duration_seconds);
+    }
+    if (entries.empty()) {
+        Logger::Error("批量转写: 未找到可用的WAV文件 {}", audio_dir);
+        return 0;
+    }
+    double total_seconds = 0.0;
+    for (double duration : durations) total_seconds += duration;
+    
+    std::ostringstream start_log;
+    start_log << "📦 批量转写: " << entries.size() << "个文件/" << std::fixed << std::setprecision(1)
+              << total_seconds / 60.0 << "分钟音频, " << num_workers << "个工作线程";
+    Logger::Info(start_log.str());
+    
+    std::atomic<size_t> completed{0};
+    Timer bulk_timer;
+    WorkStealingPool::Stats pool_stats;
+    {
+        WorkStealingPool pool(num_workers);
+        auto assignments = CorpusManifest::BalanceByDuration(durations, pool.NumWorkers());
+        for (int i = 0; i < pool.NumWorkers(); ++i) {
+            for (size_t index : assignments[i]) {
+                const CorpusManifest::Entry* entry = entries[index];
+                pool.Submit([this, entry, &on_result, &completed](int) {
+                    RecognitionResult result;
+                    if (entry->duration_seconds >= config_.long_audio_min_seconds) {
+                        // 长文件分块读取，内存只与块大小相关；并行度已在文件级，语音段逐段识别
+                        result = RecognizeWavFileStreaming(entry->path, nullptr, true, false);
+                    } else {
+                        auto audio_data = AudioFileReader::ReadWavFile(entry->path);
+                        if (audio_data.IsValid()) {
+                            result = OfflineRecognize(audio_data.samples, false, true, audio_data.sample_rate);
+                        }
+                    }
+                    if (!result.IsEmpty()) completed++;
+                    if (on_result) on_result(entry->path, result, entry->duration_seconds);
+                }, i);
+            }
+        }
+        pool.WaitIdle();
+        pool_stats = pool.GetStats();
+    }
+    
+    double elapsed_s = bulk_timer.ElapsedMs() / 1000.0;
+    std::ostringstream done_log;
+    done_log << "📦 批量转写完成: " << completed.load() << "/" << entries.size() << "个文件, 耗时: "
+             << std::fixed << std::setprecision(1) << elapsed_s << "秒, 整体RTF: "
+             << std::setprecision(4) << elapsed_s / std::max(1e-9, total_seconds)
+             << ", 窃取任务: " << pool_stats.stolen;
+    Logger::Info(done_log.str());
+    return completed.load();
+}
+
+FunASREngine::SessionAdmission FunASREngine::OpenSession(const std::string& session_id) {
+    if (!session_manager_) {
+        SessionAdmission admission;
+        admission.status = SessionManager<TwoPassSession>::Status::kCapacityExceeded;
+        admission.error = "引擎未初始化，无法打开会话: " + session_id;
+        return admission;
+    }
+    auto admission = session_manager_->Open(session_id);
+    if (!admission.Ok()) {
+        Logger::Warn("会话准入失败: {}", admission.error);
+    } else {
+        admission.session->id = session_id;
+    }
+    return admission;
+}
+
+FunASREngine::SessionHandle FunASREngine::GetSession(const std::string& session_id) const {
+    return session_manager_ ? session_manager_->Get(session_id) : nullptr;
+}
+
+bool FunASREngine::CloseSession(const std::string& session_id) {
+    return session_manager_ && session_manager_->Close(session_id);
+}
+
+void FunASREngine::ApplyChunkProfile(TwoPassSession& session) {
+    if (!chunk_controller_ || !session.streaming_cache.IsEmpty()) return;
+    auto profile = chunk_controller_->Current();
+    session.chunk_size.assign(profile.chunk_size.begin(), profile.chunk_size.end());
+    session.encoder_chunk_look_back = profile.encoder_chunk_look_back;
+    session.decoder_chunk_look_back = profile.decoder_chunk_look_back;
+}
+
+int FunASREngine::StreamingChunkMs(TwoPassSession& session) {
+    ApplyChunkProfile(session);
+    return session.ChunkMs();
+}
+
+void FunASREngine::LogChunkControllerStats(const std::string& phase) const {
+    if (!chunk_controller_) return;
+    auto stats = chunk_controller_->GetStats();
+    std::ostringstream chunk_log;
+    chunk_log << phase << "自适应分块: 当前" << stats.current_chunk_ms << "ms, 平均分块RTF="
+              << std::fixed << std::setprecision(4) << stats.avg_rtf << ", 升档" << stats.grows
+              << "次/降档" << stats.shrinks << "次 (观察" << stats.observed << "块)";
+    Logger::Info(chunk_log.str());
+}
+
 /**
  * 流式识别 - CPU版本优化
  * 
@@ -484,6 +1108,14 @@ FunASREngine::RecognitionResult FunASREngine::StreamingRecognize(
     const std::vector<float>& audio_chunk,
     TwoPassSession& session,
     bool is_final) {
+    return StreamingRecognizeChunk(audio_chunk, session, is_final, true);
+}
+
+FunASREngine::RecognitionResult FunASREngine::StreamingRecognizeChunk(
+    const std::vector<float>& audio_chunk,
+    TwoPassSession& session,
+    bool is_final,
+    bool top_level) {
     
     RecognitionResult result;
     if (!initialized_) {
@@ -491,81 +1123,83 @@ FunASREngine::RecognitionResult FunASREngine::StreamingRecognize(
         return result;
     }
     
+    session.Touch();
+    TraceRecorder::Scope trace("request", "streaming_recognize", session.id, static_cast<int64_t>(session.chunk_index++));
     try {
         Timer inference_timer;
-        
-        // 转换音频数据为numpy数组
-        py::array_t<float> audio_array = VectorToNumpy(audio_chunk);
-        
-        // 构建流式推理参数 (CPU配置)
-        py::dict kwargs;
-        kwargs["input"] = audio_array;
-        kwargs["is_final"] = is_final;
-        kwargs["chunk_size"] = py::make_tuple(
-            session.chunk_size[0],
-            session.chunk_size[1],
-            session.chunk_size[2]
-        );
-        kwargs["encoder_chunk_look_back"] = session.encoder_chunk_look_back;
-        kwargs["decoder_chunk_look_back"] = session.decoder_chunk_look_back;
-        
-        // 添加缓存状态 (修复pybind11对象生命周期问题)
-        if (!session.streaming_cache.empty()) {
-            py::dict cache_dict;
-            for (const auto& item : session.streaming_cache) {
-                cache_dict[py::str(item.first)] = item.second;
-            }
-            kwargs["cache"] = cache_dict;
-        }
-        
-        // 执行CPU流式推理
-        py::object py_result = streaming_model_.attr("generate")(**kwargs);
-        
-        // 🔄 更新缓存状态 - 修复pybind11对象赋值问题
-        if (kwargs.contains("cache")) {
-            py::dict updated_cache = kwargs["cache"];
-            session.streaming_cache.clear();
-            for (auto item : updated_cache) {
-                // 修复：使用reinterpret_borrow显式转换handle到object
-                session.streaming_cache[item.first.cast<std::string>()] = 
-                    py::reinterpret_borrow<py::object>(item.second);
-            }
-        }
+        TimedGilAcquire gil(stage_profiler_);
+        
+        // 🔄 会话首次调用时构建固定参数与持久cache，之后只替换input/is_final
+        // 自适应分块档位已由StreamingChunkMs在语句边界写入session.chunk_size
+        PyModelCache& state = session.streaming_cache;
+        py::dict kwargs = StreamingKwargs(state, session.chunk_size,
+                                          session.encoder_chunk_look_back, session.decoder_chunk_look_back);
+        kwargs["input"] = VectorToNumpy(audio_chunk);
+        kwargs["is_final"] = py::bool_(is_final);
+        
+        // 执行CPU流式推理 (cache由FunASR原地更新)
+        StageProfiler::Span generate_span(stage_profiler_, StageProfiler::Stage::kStreamingGenerate);
+        py::object py_result = streaming_generate_(**kwargs);
+        generate_span.End();
+        kwargs["input"] = py::none();  // 不在会话中保留音频
         
         // 解析结果
         result = ParseRecognitionResult(py_result, inference_timer.ElapsedMs());
         result.is_final = is_final;
         result.is_online_result = true;
         
+        if (chunk_controller_ && !audio_chunk.empty()) {
+            chunk_controller_->Observe(result.inference_time_ms / (audio_chunk.size() / 16.0), executor_->QueueDepth());
+        }
+        
         // 更新性能指标
-        {
-            std::lock_guard<std::mutex> lock(metrics_mutex_);
-            current_metrics_.total_requests++;
-            if (!result.IsEmpty()) {
-                current_metrics_.success_requests++;
-                double chunk_duration_s = audio_chunk.size() / 16000.0;
-                current_metrics_.streaming_rtf = result.inference_time_ms / (chunk_duration_s * 1000.0);
-                current_metrics_.online_latency_ms = result.inference_time_ms;
-                current_metrics_.total_audio_processed_hours += chunk_duration_s / 3600.0;
-            }
+        double chunk_rtf = 0.0;
+        live_metrics_.total_requests.Add();
+        live_metrics_.streaming_latency.Record(result.inference_time_ms);
+        if (top_level) {
+            live_metrics_.window.Record(RollingWindow::Mode::kStreaming, result.inference_time_ms,
+                                        audio_chunk.size() / 16000.0, !result.IsEmpty());
+        }
+        if (!result.IsEmpty()) {
+            live_metrics_.success_requests.Add();
+            double chunk_duration_s = audio_chunk.size() / 16000.0;
+            chunk_rtf = result.inference_time_ms / (chunk_duration_s * 1000.0);
+            live_metrics_.streaming_rtf.store(chunk_rtf, std::memory_order_relaxed);
+            live_metrics_.online_latency_ms.store(result.inference_time_ms, std::memory_order_relaxed);
+            live_metrics_.AddAudio(chunk_duration_s);
         }
         
         // 修复日志格式化
         std::ostringstream stream_log;
         stream_log << "CPU流式识别: '" << result.text << "', 耗时: " 
                   << std::fixed << std::setprecision(1) << result.inference_time_ms << "ms, RTF: "
-                  << std::fixed << std::setprecision(4) << current_metrics_.streaming_rtf;
+                  << std::fixed << std::setprecision(4) << chunk_rtf;
         Logger::Info(stream_log.str());
         
     } catch (const std::exception& e) {
         std::string error_msg = "CPU流式识别异常: " + std::string(e.what());
         Logger::Error(error_msg);
-        current_metrics_.total_requests++;
+        live_metrics_.total_requests.Add();
+        if (top_level) live_metrics_.window.RecordError();
     }
     
     return result;
 }
 
+py::dict FunASREngine::StreamingKwargs(PyModelCache& state, const std::vector<int>& chunk_size,
+                                       int encoder_chunk_look_back, int decoder_chunk_look_back) {
+    if (!state.kwargs) {
+        state.cache_dict = py::dict();
+        py::dict fixed_kwargs;
+        fixed_kwargs["chunk_size"] = py::make_tuple(chunk_size[0], chunk_size[1], chunk_size[2]);
+        fixed_kwargs["encoder_chunk_look_back"] = encoder_chunk_look_back;
+        fixed_kwargs["decoder_chunk_look_back"] = decoder_chunk_look_back;
+        fixed_kwargs["cache"] = state.cache_dict;
+        state.kwargs = fixed_kwargs;
+    }
+    return py::reinterpret_borrow<py::dict>(state.kwargs);
+}
+
 /**
  * CPU内存使用量获取 - 替代GPU显存监控
  * 
@@ -607,85 +1241,117 @@ double FunASREngine::GetCPUMemoryUsage() {
 /**
  * 2Pass识别 - CPU并行优化版本
  * 基本逻辑保持不变，但增强了错误处理和日志修复
+ * 
+ * 🆕 is_final标记输入结束: 流式与VAD以is_final=true收尾，仍未结束的语音段直接提交精化；
+ * 空块不调用模型，只做收尾
  */
 void FunASREngine::TwoPassRecognize(
     const std::vector<float>& audio_chunk,
     TwoPassSession& session,
-    std::vector<RecognitionResult>& results) {
+    std::vector<RecognitionResult>& results,
+    bool is_final) {
     
     if (!initialized_) {
         Logger::Error("引擎未初始化");
         return;
     }
     
+    session.Touch();
+    TraceRecorder::Scope trace("request", "two_pass_recognize", session.id, static_cast<int64_t>(session.chunk_index));
     try {
         Timer total_timer;
+        const uint64_t preroll_samples = 16ULL * std::max(0, config_.two_pass_preroll_ms);
+        
+        // 当前语音段以零拷贝视图进入精化队列，最终结果经会话的回调/完成队列投递
+        auto submit_segment = [this, &session, preroll_samples]() {
+            // 语音段超过会话缓冲容量时开头已被覆盖，精化只能拿到末尾部分
+            if (session.segment_overwritten > 0) {
+                Logger::Warn("会话{}语音段超过缓冲容量，开头{}ms音频已被覆盖 (可调大--session-buffer-sec)",
+                             session.id, session.segment_overwritten / 16);
+                session.segment_overwritten = 0;
+            }
+            const uint64_t end = session.audio_buffer.EndPosition();
+            AudioView complete_segment = session.audio_buffer.View(session.audio_buffer.BeginPosition(), end);
+            if (!refinement_queue_->Submit(session.refinement, std::move(complete_segment))) {
+                live_metrics_.window.RecordFailure();   // 语音段没有最终结果，计入错误率
+            }
+            
+            // 只保留末尾预滚动，作为下一句的开头
+            session.audio_buffer.DiscardBefore(end > preroll_samples ? end - preroll_samples : 0);
+            session.is_speaking = false;
+            
+            // 下一句从空的流式缓存开始 (与FunASR 2pass服务端一致，VAD缓存保留)
+            TimedGilAcquire gil(stage_profiler_);
+            session.streaming_cache.Clear();
+        };
+        
+        if (audio_chunk.empty()) {
+            if (is_final && session.is_speaking) {
+                Logger::Info("输入结束，提交未结束的语音段进行离线精化");
+                submit_segment();
+            }
+            return;
+        }
         
-        // 添加音频块到缓冲区
-        session.audio_buffer.insert(session.audio_buffer.end(),
-                                   audio_chunk.begin(), audio_chunk.end());
+        // 添加音频块到环形缓冲 (超出容量时覆盖最旧音频；静音期间的覆盖无影响，只统计语音段内的)
+        const uint64_t dropped_before = session.audio_buffer.DroppedSamples();
+        session.audio_buffer.Append(audio_chunk);
+        if (session.is_speaking) {
+            session.segment_overwritten += session.audio_buffer.DroppedSamples() - dropped_before;
+        }
         
-        // 1. CPU并行执行VAD检测和流式识别
-        std::future<VADResult> vad_future = std::async(std::launch::async, 
-            [this, &audio_chunk, &session]() {
-                return DetectVoiceActivity(audio_chunk, session.vad_cache);
-            });
-            
-        std::future<RecognitionResult> streaming_future = std::async(std::launch::async,
-            [this, &audio_chunk, &session]() {
-                return StreamingRecognize(audio_chunk, session, false);
+        // 1. 流式识别 (第一遍) 作为低延迟任务提交到共享执行器，VAD检测在调用线程中并行执行；
+        //    吞吐任务 (离线/精化) 占满执行器时仍有预留线程执行第一遍
+        std::future<RecognitionResult> streaming_future = executor_->Submit(TaskExecutor::TaskClass::kLatency,
+            [this, &audio_chunk, &session, is_final]() {
+                return StreamingRecognizeChunk(audio_chunk, session, is_final, false);
             });
         
-        // 2. 获取流式识别结果 (立即返回给用户)
-        auto streaming_result = streaming_future.get();
+        // 2. VAD检测
+        auto vad_result = DetectVoiceActivity(audio_chunk, session.vad_cache, 30000, is_final);
+        
+        // 3. 获取流式识别结果 (立即返回给用户)
+        StageProfiler::Span streaming_wait_span(stage_profiler_, StageProfiler::Stage::kStreamingWait);
+        auto streaming_result = executor_->Wait(streaming_future);
+        streaming_wait_span.End();
         if (!streaming_result.IsEmpty()) {
             streaming_result.is_online_result = true;
             results.push_back(streaming_result);
         }
         
-        // 3. 处理VAD结果
-        auto vad_result = vad_future.get();
-        current_metrics_.vad_processing_ms = vad_result.inference_time_ms;
+        // 4. 语音起点: 丢弃起点预滚动之前的静音 (VAD时间轴与缓冲绝对位置均从会话开始计)
+        if (vad_result.speech_start_ms != -1) {
+            uint64_t start_sample = 16ULL * static_cast<uint64_t>(vad_result.speech_start_ms);
+            session.audio_buffer.DiscardBefore(start_sample > preroll_samples ? start_sample - preroll_samples : 0);
+        }
         
-        // 4. 检测语音结束点
+        // 5. 检测语音结束点 (输入结束时未闭合的语音段同样提交)
         if (vad_result.speech_end_ms != -1) {
-            session.is_speaking = false;
             Logger::Info("检测到语音结束，启动离线精化处理");
-            
-            // 提取完整语音段进行离线识别
-            std::vector<float> complete_segment = session.audio_buffer;
-            
-            // CPU异步执行离线精化
-            std::thread([this, complete_segment, &session]() {
-                Timer offline_timer;
-                auto offline_result = OfflineRecognize(complete_segment, false, true);
-                if (!offline_result.IsEmpty()) {
-                    offline_result.is_offline_result = true;
-                    offline_result.is_final = true;
-                    current_metrics_.offline_refinement_ms = offline_timer.ElapsedMs();
-                    
-                    std::ostringstream offline_log;
-                    offline_log << "离线精化完成: '" << offline_result.text << "'";
-                    Logger::Info(offline_log.str());
-                }
-                session.Reset();
-            }).detach();
-            
+            submit_segment();
         } else if (vad_result.speech_start_ms != -1) {
             session.is_speaking = true;
         }
+        if (is_final && session.is_speaking) {
+            Logger::Info("输入结束，提交未结束的语音段进行离线精化");
+            submit_segment();
+        }
         
         // 更新2Pass模式性能指标
         {
-            std::lock_guard<std::mutex> lock(metrics_mutex_);
             double chunk_duration_s = audio_chunk.size() / 16000.0;
-            current_metrics_.two_pass_rtf = total_timer.ElapsedMs() / (chunk_duration_s * 1000.0);
-            current_metrics_.end_to_end_latency_ms = total_timer.ElapsedMs();
+            double elapsed_ms = total_timer.ElapsedMs();
+            live_metrics_.two_pass_rtf.store(elapsed_ms / (chunk_duration_s * 1000.0), std::memory_order_relaxed);
+            live_metrics_.end_to_end_latency_ms.store(elapsed_ms, std::memory_order_relaxed);
+            live_metrics_.two_pass_latency.Record(elapsed_ms);
+            live_metrics_.window.Record(RollingWindow::Mode::kTwoPass, elapsed_ms, chunk_duration_s,
+                                        !streaming_result.IsEmpty());
         }
         
     } catch (const std::exception& e) {
         std::string error_msg = "CPU 2Pass识别异常: " + std::string(e.what());
         Logger::Error(error_msg);
+        live_metrics_.window.RecordError();
     }
 }
 
@@ -694,44 +1360,42 @@ void FunASREngine::TwoPassRecognize(
  */
 FunASREngine::VADResult FunASREngine::DetectVoiceActivity(
     const std::vector<float>& audio_data,
-    std::map<std::string, py::object>& vad_cache,
-    int max_single_segment_time) {
+    PyModelCache& vad_cache,
+    int max_single_segment_time,
+    bool is_final,
+    int chunk_size_ms) {
     
+    TraceRecorder::Scope trace("request", "detect_vad");
     VADResult result;
     try {
         Timer vad_timer;
-        
-        // 转换音频数据
-        py::array_t<float> audio_array = VectorToNumpy(audio_data);
-        
-        // 构建VAD参数
-        py::dict kwargs;
-        kwargs["input"] = audio_array;
+        TimedGilAcquire gil(stage_profiler_);
+        
+        // 🔄 持久cache只在该缓存首次使用时构建；分段参数每次写入复用的kwargs (只是替换dict项)，
+        //    调用方改变max_single_segment_time/chunk_size时立即生效。流式/整段用法在同一缓存上不混用
+        if (!vad_cache.kwargs) {
+            vad_cache.cache_dict = py::dict();
+            py::dict fixed_kwargs;
+            fixed_kwargs["cache"] = vad_cache.cache_dict;
+            vad_cache.kwargs = fixed_kwargs;
+        }
+        py::dict kwargs = py::reinterpret_borrow<py::dict>(vad_cache.kwargs);
         kwargs["max_single_segment_time"] = max_single_segment_time;
-        
-        // 添加缓存状态
-        if (!vad_cache.empty()) {
-            py::dict cache_dict;
-            for (const auto& item : vad_cache) {
-                cache_dict[py::str(item.first)] = item.second;
-            }
-            kwargs["cache"] = cache_dict;
+        kwargs["input"] = VectorToNumpy(audio_data);
+        if (chunk_size_ms > 0) {
+            kwargs["chunk_size"] = chunk_size_ms;
+            kwargs["is_final"] = py::bool_(is_final);
         }
         
-        // 执行CPU VAD推理
-        py::object vad_py_result = vad_model_.attr("generate")(**kwargs);
-        
-        // 更新缓存 - 修复pybind11对象赋值问题
-        if (kwargs.contains("cache")) {
-            py::dict updated_cache = kwargs["cache"];
-            vad_cache.clear();
-            for (auto item : updated_cache) {
-                vad_cache[item.first.cast<std::string>()] = 
-                    py::reinterpret_borrow<py::object>(item.second);
-            }
-        }
+        // 执行CPU VAD推理 (cache由FunASR原地更新)
+        StageProfiler::Span generate_span(stage_profiler_, StageProfiler::Stage::kVadGenerate);
+        py::object vad_py_result = vad_generate_(**kwargs);
+        generate_span.End();
+        kwargs["input"] = py::none();
         
         result = ParseVADResult(vad_py_result, vad_timer.ElapsedMs());
+        live_metrics_.vad_processing_ms.store(result.inference_time_ms, std::memory_order_relaxed);
+        live_metrics_.vad_latency.Record(result.inference_time_ms);
         
     } catch (const std::exception& e) {
         std::string error_msg = "CPU VAD检测异常: " + std::string(e.what());
@@ -745,39 +1409,29 @@ FunASREngine::VADResult FunASREngine::DetectVoiceActivity(
  * 标点符号恢复 - CPU版本 (基本逻辑保持不变，修复日志格式化)
  */
 std::string FunASREngine::AddPunctuation(const std::string& text,
-                                         std::map<std::string, py::object>& punc_cache) {
+                                         PyModelCache& punc_cache) {
     if (text.empty() || punc_model_.is_none()) {
         return text;
     }
     
     try {
         Timer punc_timer;
-        
-        // 构建标点符号恢复参数
-        py::dict kwargs;
-        kwargs["input"] = text;
-        
-        // 添加缓存状态
-        if (!punc_cache.empty()) {
-            py::dict cache_dict;
-            for (const auto& item : punc_cache) {
-                cache_dict[py::str(item.first)] = item.second;
-            }
-            kwargs["cache"] = cache_dict;
+        TimedGilAcquire gil(stage_profiler_);
+        
+        // 🔄 持久cache与复用kwargs，每次只替换input
+        if (!punc_cache.kwargs) {
+            punc_cache.cache_dict = py::dict();
+            py::dict fixed_kwargs;
+            fixed_kwargs["cache"] = punc_cache.cache_dict;
+            punc_cache.kwargs = fixed_kwargs;
         }
+        py::dict kwargs = py::reinterpret_borrow<py::dict>(punc_cache.kwargs);
+        kwargs["input"] = text;
         
-        // 执行CPU标点符号恢复
-        py::object punc_result = punc_model_.attr("generate")(**kwargs);
-        
-        // 更新缓存 - 修复pybind11对象赋值问题
-        if (kwargs.contains("cache")) {
-            py::dict updated_cache = kwargs["cache"];
-            punc_cache.clear();
-            for (auto item : updated_cache) {
-                punc_cache[item.first.cast<std::string>()] = 
-                    py::reinterpret_borrow<py::object>(item.second);
-            }
-        }
+        // 执行CPU标点符号恢复 (cache由FunASR原地更新)
+        StageProfiler::Span generate_span(stage_profiler_, StageProfiler::Stage::kPuncGenerate);
+        py::object punc_result = punc_generate_(**kwargs);
+        generate_span.End();
         
         // 解析结果
         if (py::isinstance<py::list>(punc_result)) {
@@ -786,7 +1440,9 @@ std::string FunASREngine::AddPunctuation(const std::string& text,
                 py::dict first_result = result_list[0];
                 if (first_result.contains("text")) {
                     std::string punctuated_text = first_result["text"].cast<std::string>();
-                    current_metrics_.punctuation_ms = punc_timer.ElapsedMs();
+                    const double punc_ms = punc_timer.ElapsedMs();
+                    live_metrics_.punctuation_ms.store(punc_ms, std::memory_order_relaxed);
+                    live_metrics_.punctuation_latency.Record(punc_ms);
                     return punctuated_text;
                 }
             }
@@ -803,16 +1459,19 @@ std::string FunASREngine::AddPunctuation(const std::string& text,
 // ============ 辅助方法实现 (基本保持不变) ============
 
 py::array_t<float> FunASREngine::VectorToNumpy(const std::vector<float>& data) {
-    return py::array_t<float>(
-        data.size(),
-        data.data(),
-        py::cast(this)
-    );
+    return SegmentToNumpy(data.data(), data.size());
+}
+
+py::array_t<float> FunASREngine::SegmentToNumpy(const float* data, size_t size) {
+    // 不指定base对象时numpy会拷贝数据，生命周期与C++缓冲区解耦
+    StageProfiler::Span span(stage_profiler_, StageProfiler::Stage::kToNumpy);
+    return py::array_t<float>(size, data);
 }
 
 FunASREngine::RecognitionResult FunASREngine::ParseRecognitionResult(
     const py::object& result, double inference_time_ms) {
     
+    StageProfiler::Span span(stage_profiler_, StageProfiler::Stage::kParse);
     RecognitionResult parsed;
     parsed.inference_time_ms = inference_time_ms;
     
@@ -837,6 +1496,7 @@ FunASREngine::RecognitionResult FunASREngine::ParseRecognitionResult(
 FunASREngine::VADResult FunASREngine::ParseVADResult(
     const py::object& result, double inference_time_ms) {
     
+    StageProfiler::Span span(stage_profiler_, StageProfiler::Stage::kParse);
     VADResult parsed;
     parsed.inference_time_ms = inference_time_ms;
     
@@ -894,8 +1554,43 @@ bool FunASREngine::RunPerformanceTests() {
                 UpdateMetrics(offline_metrics);
             }
             
+            if (config_.enable_open_loop_test) {
+                Logger::Info("📈 开环离线压测...");
+                auto open_loop_metrics = TestOpenLoopOfflinePerformance();
+                UpdateMetrics(open_loop_metrics);
+            }
+            
+            if (config_.enable_paced_test) {
+                Logger::Info("🕒 实时节奏流式压测...");
+                auto paced_metrics = TestPacedStreamingPerformance();
+                UpdateMetrics(paced_metrics);
+            }
+            
+            if (config_.enable_capacity_search) {
+                Logger::Info("🔍 容量搜索...");
+                auto capacity_metrics = TestCapacitySearch();
+                UpdateMetrics(capacity_metrics);
+            }
+            
             Logger::Info("🎉 完整CPU性能测试套件完成！总耗时: {:.1f}秒", 
                         total_test_timer.ElapsedMs() / 1000.0);
+            
+            auto cache_stats = AudioCache::Instance().GetStats();
+            std::ostringstream cache_log;
+            cache_log << "音频解码缓存: 命中率 " << std::fixed << std::setprecision(1) << cache_stats.HitRate()
+                      << "% (" << cache_stats.hits << "/" << (cache_stats.hits + cache_stats.misses) << "), "
+                      << cache_stats.entries << "个文件, " << std::setprecision(1)
+                      << cache_stats.bytes / (1024.0 * 1024.0) << "MB, 淘汰" << cache_stats.evictions << "次";
+            Logger::Info(cache_log.str());
+
+            auto executor_stats = executor_->GetStats();
+            std::ostringstream qos_log;
+            qos_log << "QoS调度: 流式/VAD " << executor_stats.latency.executed << "个任务, 平均排队 "
+                    << std::fixed << std::setprecision(1) << executor_stats.latency.avg_wait_ms << "ms (最大 "
+                    << executor_stats.latency.max_wait_ms << "ms); 离线/精化 " << executor_stats.throughput.executed
+                    << "个任务, 平均排队 " << executor_stats.throughput.avg_wait_ms << "ms, 超时提前 "
+                    << executor_stats.throughput.aged << "次";
+            Logger::Info(qos_log.str());
         } catch (const std::exception& e) {
             Logger::Error("性能测试异常: {}", e.what());
         }
@@ -907,6 +1602,9 @@ bool FunASREngine::RunPerformanceTests() {
 }
 
 PerformanceMetrics FunASREngine::TestOfflinePerformance() {
+    if (vad_stage_) {
+        return TestOfflinePipelinePerformance();
+    }
     PerformanceMetrics metrics;
     int test_count = std::min(20, static_cast<int>(test_audio_files_.size()));
     std::vector<double> rtf_values;
@@ -914,11 +1612,15 @@ PerformanceMetrics FunASREngine::TestOfflinePerformance() {
     
     Logger::Info("开始离线测试，目标处理{}个音频文件", test_count);
     
-    for (int i = 0; i < test_count; ++i) {
-        const auto& file_path = test_audio_files_[i];
+    auto prefetcher = CreatePrefetcher(
+        {test_audio_files_.begin(), test_audio_files_.begin() + test_count}, config_.prefetch_io_threads);
+    AudioPrefetcher::Item item;
+    while (prefetcher->Next(item)) {
+        const int i = static_cast<int>(item.index);
+        const auto& file_path = item.path;
+        const auto& audio_data = *item.audio;
         Logger::Info("处理音频文件 [{}/{}]: {}", i+1, test_count, file_path);
         
-        auto audio_data = AudioFileReader::ReadWavFile(file_path);
         if (!audio_data.IsValid()) {
             Logger::Warn("跳过无效音频文件: {}", file_path);
             continue;
@@ -927,7 +1629,7 @@ PerformanceMetrics FunASREngine::TestOfflinePerformance() {
         Timer test_timer;
         Logger::Info("开始识别，音频时长: {:.2f}秒", audio_data.duration_seconds);
         
-        auto result = OfflineRecognize(audio_data.samples, true, true);
+        auto result = OfflineRecognize(audio_data.samples, true, true, audio_data.sample_rate);
         double elapsed_ms = test_timer.ElapsedMs();
         
         if (!result.IsEmpty()) {
@@ -960,18 +1662,165 @@ PerformanceMetrics FunASREngine::TestOfflinePerformance() {
 
 
 
+PerformanceMetrics FunASREngine::TestOfflinePipelinePerformance() {
+    PerformanceMetrics metrics;
+    int test_count = std::min(20, static_cast<int>(test_audio_files_.size()));
+    Logger::Info("开始流水线离线测试，目标处理{}个音频文件", test_count);
+    
+    struct PendingRequest {
+        std::string path;
+        double duration_seconds;
+        std::future<RecognitionResult> future;
+    };
+    std::vector<PendingRequest> pending;
+    Timer wall_timer;
+    
+    // 提交阶段受第一阶段队列背压，文件预取与识别互相重叠
+    auto prefetcher = CreatePrefetcher(
+        {test_audio_files_.begin(), test_audio_files_.begin() + test_count}, config_.prefetch_io_threads);
+    AudioPrefetcher::Item item;
+    while (prefetcher->Next(item)) {
+        const auto& audio_data = *item.audio;
+        if (!audio_data.IsValid()) {
+            Logger::Warn("跳过无效音频文件: {}", item.path);
+            continue;
+        }
+        pending.push_back({item.path, audio_data.duration_seconds,
+                           SubmitPipelined(audio_data.samples, audio_data.sample_rate)});
+    }
+    
+    double total_audio_duration = 0.0;
+    double total_latency_ms = 0.0;
+    int success_count = 0;
+    for (auto& request : pending) {
+        auto result = request.future.get();
+        if (result.IsEmpty()) {
+            Logger::Error("流水线识别失败: {}", request.path);
+            continue;
+        }
+        success_count++;
+        total_audio_duration += request.duration_seconds;
+        total_latency_ms += result.inference_time_ms;
+        std::ostringstream result_log;
+        result_log << "流水线识别完成: " << request.path << ", 延迟=" << std::fixed << std::setprecision(1)
+                   << result.inference_time_ms << "ms, 结果: '" << result.text.substr(0, 50) << "'";
+        Logger::Info(result_log.str());
+    }
+    double wall_ms = wall_timer.ElapsedMs();
+    
+    if (success_count > 0) {
+        // 流水线模式的RTF按整体吞吐计算 (墙钟时间/音频总时长)
+        metrics.offline_rtf = wall_ms / (total_audio_duration * 1000.0);
+        metrics.total_audio_processed_hours = total_audio_duration / 3600.0;
+        metrics.test_files_count = success_count;
+        
+        std::ostringstream summary_log;
+        summary_log << "流水线离线测试完成: 成功" << success_count << "/" << pending.size()
+                    << "个文件, 吞吐RTF=" << std::fixed << std::setprecision(4) << metrics.offline_rtf
+                    << ", 平均请求延迟=" << std::setprecision(1) << total_latency_ms / success_count << "ms";
+        Logger::Info(summary_log.str());
+    } else {
+        Logger::Error("流水线离线测试失败: 没有成功处理任何音频文件");
+    }
+    
+    for (const auto* stage : {vad_stage_.get(), asr_stage_.get(), punc_stage_.get()}) {
+        auto stats = stage->GetStats();
+        std::ostringstream stage_log;
+        stage_log << "流水线阶段[" << stage->Name() << "]: 处理" << stats.processed << "个请求, 平均排队 "
+                  << std::fixed << std::setprecision(2) << stats.avg_queued << ", 峰值排队 " << stats.peak_queued
+                  << ", 平均批大小 " << stats.AvgBatch();
+        Logger::Info(stage_log.str());
+    }
+    return metrics;
+}
+
+PerformanceMetrics FunASREngine::TestOpenLoopOfflinePerformance() {
+    PerformanceMetrics metrics;
+    std::vector<double> trace;
+    if (!config_.arrival_trace_path.empty() &&
+        !OpenLoopGenerator::LoadTrace(config_.arrival_trace_path, trace)) {
+        return metrics;
+    }
+    
+    // 未指定速率时: 轨迹按原始速率回放一档，泊松按默认四档
+    std::vector<double> rates = config_.open_loop_rates;
+    if (rates.empty()) {
+        if (trace.empty()) {
+            rates = {0.5, 1.0, 2.0, 4.0};
+        } else {
+            rates.push_back(OpenLoopGenerator::OfferedRate(trace));
+        }
+    }
+    const size_t request_count = trace.empty() ? static_cast<size_t>(config_.open_loop_requests) : trace.size();
+    
+    // 请求按序号轮流使用测试文件，先全部解码，计时不含文件I/O
+    const size_t file_count = std::min(request_count, test_audio_files_.size());
+    std::vector<AudioFileReader::AudioDataPtr> audios;
+    audios.reserve(file_count);
+    for (size_t i = 0; i < file_count; ++i) {
+        audios.push_back(LoadTestAudio(test_audio_files_[i]));
+    }
+    if (audios.empty()) return metrics;
+    
+    OpenLoopGenerator generator(config_.open_loop_workers);
+    std::ostringstream start_log;
+    start_log << "开环压测: " << rates.size() << "档负载, 每档" << request_count << "个请求, "
+              << generator.NumWorkers() << "个工作线程, 到达过程: "
+              << (trace.empty() ? "泊松" : "轨迹 " + config_.arrival_trace_path);
+    Logger::Info(start_log.str());
+    
+    auto request = [this, &audios](size_t index) -> double {
+        const auto& audio_data = *audios[index % audios.size()];
+        if (!audio_data.IsValid()) return -1.0;
+        auto result = OfflineRecognize(audio_data.samples, true, true, audio_data.sample_rate);
+        return result.IsEmpty() ? -1.0 : audio_data.duration_seconds;
+    };
+    
+    for (size_t r = 0; r < rates.size(); ++r) {
+        auto arrivals = trace.empty()
+            ? OpenLoopGenerator::PoissonArrivals(rates[r], request_count, config_.open_loop_seed + static_cast<uint32_t>(r))
+            : OpenLoopGenerator::ScaleToRate(trace, rates[r]);
+        auto report = generator.Run(arrivals, request);
+        
+        std::ostringstream oss;
+        oss << "开环负载 [" << (r + 1) << "/" << rates.size() << "] 提供" << std::fixed << std::setprecision(2)
+            << report.offered_rps << "请求/秒: 完成" << report.completed << "/" << report.submitted
+            << " (" << report.achieved_rps << "请求/秒, " << std::setprecision(1) << report.audio_speed
+            << "倍实时), 耗时" << report.wall_seconds << "秒";
+        Logger::Info(oss.str());
+        Logger::Info("  排队等待: {}", report.queue_wait.ToString());
+        Logger::Info("  服务时间: {}", report.service.ToString());
+        Logger::Info("  总延迟: {}", report.latency.ToString());
+        
+        PerformanceMetrics::LoadPoint point;
+        point.offered_rps = report.offered_rps;
+        point.achieved_rps = report.achieved_rps;
+        point.queue_p99_ms = report.queue_wait.p99_ms;
+        point.latency_p50_ms = report.latency.p50_ms;
+        point.latency_p99_ms = report.latency.p99_ms;
+        metrics.open_loop_curve.push_back(point);
+    }
+    return metrics;
+}
+
 PerformanceMetrics FunASREngine::TestStreamingPerformance() {
     PerformanceMetrics metrics;
     int test_count = std::min(15, static_cast<int>(test_audio_files_.size()));
     std::vector<double> rtf_values, latency_values;
     Logger::Info("流式测试使用{}个音频文件", test_count);
 
-    for (int i = 0; i < test_count; ++i) {
-        const auto& file_path = test_audio_files_[i];
-        auto audio_data = AudioFileReader::ReadWavFile(file_path);
+    auto prefetcher = CreatePrefetcher(
+        {test_audio_files_.begin(), test_audio_files_.begin() + test_count}, config_.prefetch_io_threads);
+    AudioPrefetcher::Item item;
+    while (prefetcher->Next(item)) {
+        const int i = static_cast<int>(item.index);
+        const auto& audio_data = *item.audio;
         if (!audio_data.IsValid()) continue;
-        auto chunks = SimulateStreamingChunks(audio_data.samples);
-        TwoPassSession session;
+        const std::string session_id = "streaming-test-" + std::to_string(i);
+        auto admission = OpenSession(session_id);
+        if (!admission.Ok()) continue;
+        TwoPassSession& session = *admission.session;
+        auto chunks = SimulateStreamingChunks(audio_data.samples, StreamingChunkMs(session));
         for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
             bool is_final = (chunk_idx == chunks.size() - 1);
             auto result = StreamingRecognize(chunks[chunk_idx], session, is_final);
@@ -982,6 +1831,7 @@ PerformanceMetrics FunASREngine::TestStreamingPerformance() {
                 latency_values.push_back(result.inference_time_ms);
             }
         }
+        CloseSession(session_id);
         std::ostringstream oss;
         oss << "流式测试 [" << (i+1) << "/" << test_count << "]: "
             << std::fixed << std::setprecision(1) << audio_data.duration_seconds << "秒, "
@@ -1000,6 +1850,7 @@ PerformanceMetrics FunASREngine::TestStreamingPerformance() {
             << ", 平均延迟=" << std::fixed << std::setprecision(1) << metrics.online_latency_ms << "ms";
         Logger::Info(oss.str());
     }
+    LogChunkControllerStats("流式测试");
     return metrics;
 }
 
@@ -1010,24 +1861,42 @@ PerformanceMetrics FunASREngine::TestTwoPassPerformance() {
     std::vector<double> rtf_values;
     Logger::Info("2Pass测试使用{}个音频文件", test_count);
 
-    for (int i = 0; i < test_count; ++i) {
-        const auto& file_path = test_audio_files_[i];
-        auto audio_data = AudioFileReader::ReadWavFile(file_path);
+    auto prefetcher = CreatePrefetcher(
+        {test_audio_files_.begin(), test_audio_files_.begin() + test_count}, config_.prefetch_io_threads);
+    AudioPrefetcher::Item item;
+    while (prefetcher->Next(item)) {
+        const int i = static_cast<int>(item.index);
+        const auto& audio_data = *item.audio;
         if (!audio_data.IsValid()) continue;
-        auto chunks = SimulateStreamingChunks(audio_data.samples);
-        TwoPassSession session;
+        const std::string session_id = "2pass-test-" + std::to_string(i);
+        auto admission = OpenSession(session_id);
+        if (!admission.Ok()) continue;
+        TwoPassSession& session = *admission.session;
         std::vector<RecognitionResult> results;
+        std::vector<float> chunk;
+        size_t chunk_count = 0;
         Timer two_pass_timer;
-        for (size_t chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx) {
-            TwoPassRecognize(chunks[chunk_idx], session, results);
+        // 每句结束后分块档位可能变化，按会话当前档位逐块切分
+        for (size_t offset = 0; offset < audio_data.samples.size(); offset += chunk.size()) {
+            size_t chunk_samples = static_cast<size_t>(StreamingChunkMs(session)) * 16;
+            size_t end = std::min(offset + chunk_samples, audio_data.samples.size());
+            chunk.assign(audio_data.samples.begin() + offset, audio_data.samples.begin() + end);
+            TwoPassRecognize(chunk, session, results);
+            chunk_count++;
         }
         double elapsed_ms = two_pass_timer.ElapsedMs();
         double rtf = elapsed_ms / (audio_data.duration_seconds * 1000.0);
         rtf_values.push_back(rtf);
+        
+        // 等待离线精化结果，不计入流式RTF
+        session.WaitForRefinements();
+        auto final_results = session.TakeFinalResults();
+        CloseSession(session_id);
         std::ostringstream oss;
         oss << "2Pass测试 [" << (i+1) << "/" << test_count << "]: "
             << std::fixed << std::setprecision(1) << audio_data.duration_seconds << "秒, "
-            << "RTF=" << std::setprecision(4) << rtf << ", 输出" << results.size() << "个结果";
+            << "RTF=" << std::setprecision(4) << rtf << ", " << chunk_count << "个分块, 输出"
+            << results.size() << "个在线结果/" << final_results.size() << "个精化结果";
         Logger::Info(oss.str());
     }
     if (!rtf_values.empty()) {
@@ -1041,55 +1910,368 @@ PerformanceMetrics FunASREngine::TestTwoPassPerformance() {
     return metrics;
 }
 
+/**
+ * 实时节奏流式压测 - 每路会话一个调用线程，分块按音频时间释放
+ * 
+ * 🆕 快速灌入分块只能测出纯计算吞吐；真实麦克风每600ms才产生一块，
+ * 用户感受到的是"这块音频采完"到"部分结果返回"的时间，排队与计算都计入其中。
+ */
+FunASREngine::PacedStreamingReport FunASREngine::RunPacedStreaming(
+    int num_sessions, int stagger_ms, double max_audio_seconds) {
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+    PacedStreamingReport report;
+    if (test_audio_files_.empty() || num_sessions <= 0) return report;
+    
+    // 先解码全部音频 (经解码缓存)，压测计时不含文件I/O
+    std::vector<AudioFileReader::AudioDataPtr> audios;
+    audios.reserve(num_sessions);
+    for (int i = 0; i < num_sessions; ++i) {
+        audios.push_back(LoadTestAudio(test_audio_files_[i % test_audio_files_.size()]));
+    }
+    
+    struct CallerSamples {
+        std::vector<double> queue_delay, gil_wait, compute, latency;
+        double audio_ms = 0.0;
+        bool opened = false;
+        bool rejected = false;
+    };
+    std::vector<CallerSamples> samples(num_sessions);
+    std::vector<std::thread> callers;
+    callers.reserve(num_sessions);
+    
+    const auto base = Clock::now();
+    for (int i = 0; i < num_sessions; ++i) {
+        callers.emplace_back([this, i, base, stagger_ms, max_audio_seconds, &audios, &samples]() {
+            CallerSamples& out = samples[i];
+            const auto& audio = *audios[i];
+            if (!audio.IsValid()) return;
+            size_t total = audio.samples.size();
+            if (max_audio_seconds > 0) {
+                total = std::min(total, static_cast<size_t>(max_audio_seconds * 16000));
+            }
+            
+            std::this_thread::sleep_until(base + std::chrono::milliseconds(static_cast<int64_t>(i) * stagger_ms));
+            const std::string session_id = "paced-" + std::to_string(i);
+            auto admission = OpenSession(session_id);
+            if (!admission.Ok()) {
+                out.rejected = true;
+                return;
+            }
+            out.opened = true;
+            
+            TwoPassSession& session = *admission.session;
+            const auto start = Clock::now();
+            std::vector<float> chunk;
+            try {
+                for (size_t offset = 0; offset < total; offset += chunk.size()) {
+                    size_t end = std::min(offset + static_cast<size_t>(StreamingChunkMs(session)) * 16, total);
+                    chunk.assign(audio.samples.begin() + offset, audio.samples.begin() + end);
+                    // 块末尾对应的音频时间到达后才可送出 (16kHz: 16个采样/毫秒)
+                    auto release = start + std::chrono::microseconds(static_cast<int64_t>(end) * 1000 / 16);
+                    std::this_thread::sleep_until(release);
+                    
+                    // 识别耗时在获取GIL处拆开: 等待GIL是会话间争用，其余才是本块计算
+                    const double gil_before = t_gil_wait_ms;
+                    auto begin = Clock::now();
+                    StreamingRecognize(chunk, session, end == total);
+                    auto finish = Clock::now();
+                    const double gil_wait = t_gil_wait_ms - gil_before;
+                    out.queue_delay.push_back(Ms(begin - release).count());
+                    out.gil_wait.push_back(gil_wait);
+                    out.compute.push_back(std::max(0.0, Ms(finish - begin).count() - gil_wait));
+                    out.latency.push_back(Ms(finish - release).count());
+                    out.audio_ms += chunk.size() / 16.0;
+                }
+            } catch (const std::exception& e) {
+                std::ostringstream oss;
+                oss << "实时节奏会话-" << i << " 异常: " << e.what();
+                Logger::Error(oss.str());
+            }
+            CloseSession(session_id);
+        });
+    }
+    for (auto& caller : callers) caller.join();
+    report.wall_seconds = Ms(Clock::now() - base).count() / 1000.0;
+    
+    std::vector<double> queue_delay, gil_wait, compute, latency;
+    double busy_ms = 0.0;
+    for (const auto& out : samples) {
+        if (out.opened) report.sessions++;
+        if (out.rejected) report.rejected++;
+        report.audio_seconds += out.audio_ms / 1000.0;
+        queue_delay.insert(queue_delay.end(), out.queue_delay.begin(), out.queue_delay.end());
+        gil_wait.insert(gil_wait.end(), out.gil_wait.begin(), out.gil_wait.end());
+        compute.insert(compute.end(), out.compute.begin(), out.compute.end());
+        latency.insert(latency.end(), out.latency.begin(), out.latency.end());
+        for (double ms : out.gil_wait) busy_ms += ms;
+        for (double ms : out.compute) busy_ms += ms;
+    }
+    report.chunks = latency.size();
+    if (report.audio_seconds > 0) report.rtf = busy_ms / (report.audio_seconds * 1000.0);
+    report.queue_delay = LatencySummary::FromSamples(std::move(queue_delay));
+    report.gil_wait = LatencySummary::FromSamples(std::move(gil_wait));
+    report.compute = LatencySummary::FromSamples(std::move(compute));
+    report.partial_latency = LatencySummary::FromSamples(std::move(latency));
+    return report;
+}
+
+FunASREngine::CapacityReport FunASREngine::FindMaxSessions(
+    const CapacitySlo& slo, int max_sessions, double probe_seconds) {
+    CapacityReport report;
+    max_sessions = std::max(1, std::min(max_sessions, config_.max_concurrent_sessions));
+    
+    auto probe = [&](int sessions) {
+        CapacityReport::Probe result;
+        result.sessions = sessions;
+        // 阶段分析器是累计值，探测前后各取一次快照，差值即本次探测的阶段分布
+        auto stages_before = stage_profiler_.Snapshot();
+        result.result = RunPacedStreaming(sessions, config_.paced_stagger_ms, probe_seconds);
+        auto stages_after = stage_profiler_.Snapshot();
+        for (size_t i = 0; i < StageProfiler::kStageCount; ++i) {
+            stages_after[i].Subtract(stages_before[i]);
+            result.stage_p99_ms[i] = stages_after[i].Count() > 0 ? stages_after[i].PercentileMs(0.99) : 0.0;
+        }
+        const auto& paced = result.result;
+        result.passed = paced.rejected == 0 && paced.chunks > 0 &&
+                        paced.partial_latency.p99_ms < slo.max_p99_latency_ms && paced.rtf < slo.max_rtf;
+        std::ostringstream oss;
+        oss << "容量探测 " << sessions << "路: " << (result.passed ? "✅ 满足" : "❌ 违反") << " SLO, P99延迟 "
+            << std::fixed << std::setprecision(1) << paced.partial_latency.p99_ms << "ms (排队P99 "
+            << paced.queue_delay.p99_ms << "ms, GIL等待P99 " << paced.gil_wait.p99_ms
+            << "ms, 计算P99 " << paced.compute.p99_ms << "ms), RTF "
+            << std::setprecision(4) << paced.rtf;
+        if (paced.rejected > 0) oss << ", 拒绝" << paced.rejected << "路";
+        Logger::Info(oss.str());
+        report.probes.push_back(result);
+        return result.passed;
+    };
+    
+    // 先加倍找到首个失败点，再在 (最后通过, 首次失败) 之间二分
+    int passed = 0, failed = 0;
+    for (int sessions = 1; ; sessions = std::min(sessions * 2, max_sessions)) {
+        if (probe(sessions)) {
+            passed = sessions;
+            if (sessions == max_sessions) break;
+        } else {
+            failed = sessions;
+            break;
+        }
+    }
+    while (failed > 0 && failed - passed > 1) {
+        int mid = passed + (failed - passed) / 2;
+        if (probe(mid)) {
+            passed = mid;
+        } else {
+            failed = mid;
+        }
+    }
+    report.max_sessions = passed;
+    report.hit_ceiling = failed == 0;
+    
+    if (report.hit_ceiling) {
+        std::ostringstream oss;
+        oss << "搜索上限" << max_sessions << "路 (max_concurrent_sessions) 仍满足SLO";
+        report.bottleneck = oss.str();
+        return report;
+    }
+    const CapacityReport::Probe* failing = nullptr;
+    for (const auto& p : report.probes) {
+        if (p.sessions == failed) failing = &p;
+    }
+    // 单会话探测作为无争用基线，瓶颈为P99增幅 (毫秒) 最大的识别阶段；单会话即失败时取P99最大的阶段
+    const CapacityReport::Probe& baseline = report.probes.front();
+    const bool single_session = failing == &baseline;
+    size_t worst = 0;
+    double worst_growth = -1.0;
+    for (size_t i = 0; i < StageProfiler::kStageCount; ++i) {
+        double growth = failing->stage_p99_ms[i] - (single_session ? 0.0 : baseline.stage_p99_ms[i]);
+        if (growth > worst_growth) {
+            worst_growth = growth;
+            worst = i;
+        }
+    }
+    const auto& paced = failing->result;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    if (paced.queue_delay.p99_ms > paced.gil_wait.p99_ms + paced.compute.p99_ms) {
+        oss << "分块积压 (排队P99 " << paced.queue_delay.p99_ms << "ms), ";
+    }
+    oss << "阶段 " << StageProfiler::StageName(static_cast<StageProfiler::Stage>(worst)) << ": P99 ";
+    if (single_session) {
+        oss << failing->stage_p99_ms[worst] << "ms (1路即不满足SLO)";
+    } else {
+        oss << baseline.stage_p99_ms[worst] << "ms (1路) → " << failing->stage_p99_ms[worst] << "ms (" << failed << "路)";
+    }
+    report.bottleneck = oss.str();
+    return report;
+}
+
+PerformanceMetrics FunASREngine::TestCapacitySearch() {
+    PerformanceMetrics metrics;
+    CapacitySlo slo;
+    slo.max_p99_latency_ms = config_.slo_p99_latency_ms;
+    slo.max_rtf = config_.slo_max_rtf;
+    const int max_sessions = config_.capacity_max_sessions > 0
+        ? config_.capacity_max_sessions : config_.max_concurrent_sessions;
+    std::ostringstream start_log;
+    start_log << "容量搜索: SLO 部分结果P99 < " << std::fixed << std::setprecision(0) << slo.max_p99_latency_ms
+              << "ms 且 RTF < " << std::setprecision(2) << slo.max_rtf << ", 上限" << max_sessions
+              << "路, 每个探测点" << std::setprecision(0) << config_.capacity_probe_seconds << "秒音频";
+    Logger::Info(start_log.str());
+    
+    auto report = FindMaxSessions(slo, max_sessions, config_.capacity_probe_seconds);
+    Logger::Info("容量搜索完成: 最大可持续并发 {}路 ({}个探测点), 瓶颈: {}",
+                 report.max_sessions, report.probes.size(), report.bottleneck);
+    if (!report.hit_ceiling && report.max_sessions > 0) {
+        Logger::Info("建议部署参数: --concurrent {}", report.max_sessions);
+    }
+    LogChunkControllerStats("容量搜索");
+    
+    metrics.capacity_max_sessions = report.max_sessions;
+    metrics.capacity_bottleneck = report.bottleneck;
+    return metrics;
+}
+
+PerformanceMetrics FunASREngine::TestPacedStreamingPerformance() {
+    PerformanceMetrics metrics;
+    const int num_sessions = config_.paced_sessions > 0 ? config_.paced_sessions : config_.max_concurrent_sessions;
+    std::ostringstream start_log;
+    start_log << "启动实时节奏流式压测: " << num_sessions << "路会话, 间隔" << config_.paced_stagger_ms
+              << "ms启动, 每路最多" << std::fixed << std::setprecision(0) << config_.paced_max_audio_seconds << "秒音频";
+    Logger::Info(start_log.str());
+    
+    auto report = RunPacedStreaming(num_sessions, config_.paced_stagger_ms, config_.paced_max_audio_seconds);
+    std::ostringstream oss;
+    oss << "实时节奏压测完成: " << report.sessions << "路 (拒绝" << report.rejected << "), "
+        << report.chunks << "个分块, " << std::fixed << std::setprecision(1) << report.audio_seconds
+        << "秒音频/" << report.wall_seconds << "秒, RTF=" << std::setprecision(4) << report.rtf;
+    Logger::Info(oss.str());
+    Logger::Info("  排队延迟: {}", report.queue_delay.ToString());
+    Logger::Info("  GIL等待: {}", report.gil_wait.ToString());
+    Logger::Info("  计算耗时: {}", report.compute.ToString());
+    Logger::Info("  部分结果延迟: {}", report.partial_latency.ToString());
+    LogChunkControllerStats("实时节奏压测");
+    
+    metrics.paced_sessions = report.sessions;
+    metrics.paced_rtf = report.rtf;
+    metrics.paced_latency_p50_ms = report.partial_latency.p50_ms;
+    metrics.paced_latency_p95_ms = report.partial_latency.p95_ms;
+    metrics.paced_latency_p99_ms = report.partial_latency.p99_ms;
+    metrics.paced_queue_p99_ms = report.queue_delay.p99_ms;
+    return metrics;
+}
+
 
 PerformanceMetrics FunASREngine::TestConcurrentPerformance() {
     PerformanceMetrics metrics;
     const int num_workers = config_.max_concurrent_sessions;
-    const int files_per_worker = std::max(1, static_cast<int>(test_audio_files_.size()) / num_workers);
+    
+    // 按音频总时长 (而非文件个数) 预分配初始队列，运行时再由工作窃取补齐快慢差异
+    std::vector<double> durations;
+    durations.reserve(test_audio_files_.size());
+    for (const auto& file : test_audio_files_) {
+        durations.push_back(GetTestAudioDuration(file));
+    }
+    auto assignments = CorpusManifest::BalanceByDuration(durations, num_workers);
+    
+    double max_worker_seconds = 0.0, total_seconds = 0.0;
+    for (const auto& assignment : assignments) {
+        double worker_seconds = 0.0;
+        for (size_t index : assignment) worker_seconds += durations[index];
+        max_worker_seconds = std::max(max_worker_seconds, worker_seconds);
+        total_seconds += worker_seconds;
+    }
     std::ostringstream start_log;
-    start_log << "启动" << num_workers << "路并发测试，每路处理" << files_per_worker << "个文件";
+    start_log << "启动" << num_workers << "路并发测试，共" << test_audio_files_.size() << "个文件/"
+              << std::fixed << std::setprecision(1) << total_seconds << "秒音频，按时长预分配+工作窃取，单Worker初始最多"
+              << max_worker_seconds << "秒";
     Logger::Info(start_log.str());
 
-    std::vector<std::future<void>> futures;
-    std::vector<PerformanceMetrics> worker_results(num_workers);
+    // 音频由预取线程加载，按各Worker队列轮流取一个的顺序 (近似实际处理顺序) 预取，
+    // 每个文件对应一个future，由实际执行该文件的Worker取走
+    std::vector<size_t> load_order;
+    size_t rounds = 0;
+    for (const auto& assignment : assignments) rounds = std::max(rounds, assignment.size());
+    for (size_t round = 0; round < rounds; ++round) {
+        for (const auto& assignment : assignments) {
+            if (round < assignment.size()) load_order.push_back(assignment[round]);
+        }
+    }
+    std::vector<std::string> load_files;
+    load_files.reserve(load_order.size());
+    for (size_t index : load_order) load_files.push_back(test_audio_files_[index]);
+    
+    std::vector<std::promise<AudioFileReader::AudioDataPtr>> audio_promises(test_audio_files_.size());
+    std::vector<std::future<AudioFileReader::AudioDataPtr>> audio_futures;
+    audio_futures.reserve(audio_promises.size());
+    for (auto& promise : audio_promises) audio_futures.push_back(promise.get_future());
+    
+    auto prefetcher = CreatePrefetcher(std::move(load_files), config_.prefetch_io_threads);
+    std::thread feeder([&prefetcher, &load_order, &audio_promises]() {
+        std::vector<bool> delivered(audio_promises.size(), false);
+        AudioPrefetcher::Item item;
+        while (prefetcher->Next(item)) {
+            const size_t index = load_order[item.index];
+            audio_promises[index].set_value(item.audio);
+            delivered[index] = true;
+        }
+        // 预取提前结束时以空音频放行等待中的Worker
+        for (size_t i = 0; i < delivered.size(); ++i) {
+            if (!delivered[i]) audio_promises[i].set_value(std::make_shared<const AudioFileReader::AudioData>());
+        }
+    });
+
+    std::vector<ConcurrentWorkerTotals> worker_totals(num_workers);
     std::atomic<int> active_sessions{0};
     Timer concurrent_timer;
-
-    for (int i = 0; i < num_workers; ++i) {
-        int start_idx = i * files_per_worker;
-        int end_idx = std::min(start_idx + files_per_worker, static_cast<int>(test_audio_files_.size()));
-        std::vector<std::string> worker_files(
-            test_audio_files_.begin() + start_idx,
-            test_audio_files_.begin() + end_idx
-        );
-        futures.emplace_back(std::async(std::launch::async,
-            [this, i, worker_files, &active_sessions, &worker_results]() {
-                ConcurrentTestWorker(i, worker_files, active_sessions, worker_results);
-            })
-        );
+    WorkStealingPool::Stats pool_stats;
+    {
+        WorkStealingPool pool(num_workers);
+        for (int i = 0; i < num_workers; ++i) {
+            for (size_t index : assignments[i]) {
+                const std::string& file = test_audio_files_[index];
+                auto& audio = audio_futures[index];
+                pool.Submit([this, &file, &audio, &active_sessions, &worker_totals](int worker_id) {
+                    ConcurrentTestWorker(worker_id, file, audio, active_sessions, worker_totals[worker_id]);
+                }, i);
+            }
+        }
+        pool.WaitIdle();
+        pool_stats = pool.GetStats();
     }
-
-    for (auto& future : futures) future.wait();
+    feeder.join();
 
     double total_time_s = concurrent_timer.ElapsedMs() / 1000.0;
-    double total_rtf = 0;
-    int valid_results = 0;
-    for (const auto& result : worker_results) {
-        if (result.streaming_rtf > 0) {
-            total_rtf += result.streaming_rtf;
-            valid_results++;
-        }
+    // 整体RTF = Σ识别耗时 / Σ音频时长 (逐文件RTF的算术平均会让短文件与长文件等权)
+    double compute_ms = 0.0, audio_seconds = 0.0;
+    for (int i = 0; i < num_workers; ++i) {
+        compute_ms += worker_totals[i].compute_ms;
+        audio_seconds += worker_totals[i].audio_seconds;
+        std::ostringstream worker_log;
+        worker_log << "并发Worker-" << i << " 完成: 处理" << worker_totals[i].files << "个文件";
+        Logger::Info(worker_log.str());
     }
-    if (valid_results > 0) {
-        metrics.streaming_rtf = total_rtf / valid_results;
+    if (audio_seconds > 0) {
+        metrics.streaming_rtf = compute_ms / (audio_seconds * 1000.0);
     }
     metrics.concurrent_sessions = num_workers;
 
     std::ostringstream oss;
-    oss << "并发测试完成: " << num_workers << "路并发, 平均RTF=" 
+    oss << "并发测试完成: " << num_workers << "路并发, 整体RTF=" 
         << std::fixed << std::setprecision(4) << metrics.streaming_rtf 
-        << ", 总耗时=" << std::fixed << std::setprecision(1) << total_time_s << "秒";
+        << ", 总耗时=" << std::fixed << std::setprecision(1) << total_time_s << "秒"
+        << ", 窃取任务=" << pool_stats.stolen << "/" << pool_stats.executed;
     Logger::Info(oss.str());
+    LogChunkControllerStats("并发测试");
+    
+    auto session_stats = session_manager_->GetStats();
+    std::ostringstream session_log;
+    session_log << "会话池: 打开" << session_stats.opened << "次 (复用" << session_stats.reused
+                << "), 峰值" << session_stats.peak_active << "/" << session_manager_->MaxSessions()
+                << ", 拒绝" << session_stats.rejected << ", 空闲淘汰" << session_stats.evicted
+                << ", 池中空闲" << session_stats.pooled;
+    Logger::Info(session_log.str());
 
     return metrics;
 }
@@ -1097,43 +2279,76 @@ PerformanceMetrics FunASREngine::TestConcurrentPerformance() {
 
 void FunASREngine::ConcurrentTestWorker(
     int worker_id,
-    const std::vector<std::string>& worker_files,
+    const std::string& file_path,
+    std::future<AudioFileReader::AudioDataPtr>& audio,
     std::atomic<int>& active_sessions,
-    std::vector<PerformanceMetrics>& results) {
+    ConcurrentWorkerTotals& totals) {
+    AudioFileReader::AudioDataPtr audio_ptr = audio.get();
+    const auto& audio_data = *audio_ptr;
+    if (!audio_data.IsValid()) {
+        Logger::Warn("跳过无效音频文件: {}", file_path);
+        return;
+    }
+    
+    // 每个Worker同一时刻只打开一个会话，Worker数即max_concurrent_sessions，不会超出准入上限
+    const std::string session_id = "concurrent-" + std::to_string(worker_id);
+    auto admission = OpenSession(session_id);
+    if (!admission.Ok()) return;
+    
+    active_sessions++;
     try {
-        active_sessions++;
-        PerformanceMetrics worker_metrics;
-        std::vector<double> rtf_values;
-        Timer worker_timer;
-        for (const auto& file_path : worker_files) {
-            auto audio_data = AudioFileReader::ReadWavFile(file_path);
-            if (!audio_data.IsValid()) continue;
-            auto chunks = SimulateStreamingChunks(audio_data.samples);
-            TwoPassSession session;
-            for (const auto& chunk : chunks) {
-                auto result = StreamingRecognize(chunk, session, false);
-                double elapsed_ms = worker_timer.ElapsedMs();
-                double rtf = elapsed_ms / (audio_data.duration_seconds * 1000.0);
-                rtf_values.push_back(rtf);
-            }
+        TwoPassSession& session = *admission.session;
+        auto chunks = SimulateStreamingChunks(audio_data.samples, StreamingChunkMs(session));
+        Timer file_timer;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            StreamingRecognize(chunks[i], session, i + 1 == chunks.size());
         }
-        if (!rtf_values.empty()) {
-            double sum = 0;
-            for (double rtf : rtf_values) sum += rtf;
-            worker_metrics.streaming_rtf = sum / rtf_values.size();
-        }
-        results[worker_id] = worker_metrics;
         active_sessions--;
-        std::ostringstream oss;
-        oss << "并发Worker-" << worker_id << " 完成: 处理" << worker_files.size()
-            << "个文件, 平均RTF=" << std::fixed << std::setprecision(4) << worker_metrics.streaming_rtf;
-        Logger::Info(oss.str());
+        CloseSession(session_id);
+        
+        totals.files++;
+        totals.compute_ms += file_timer.ElapsedMs();
+        totals.audio_seconds += audio_data.duration_seconds;
     } catch (const std::exception& e) {
         std::ostringstream oss;
-        oss << "并发Worker-" << worker_id << " 异常: " << e.what();
+        oss << "并发Worker-" << worker_id << " 处理 " << file_path << " 异常: " << e.what();
         Logger::Error(oss.str());
         active_sessions--;
+        CloseSession(session_id);
+    }
+}
+
+/**
+ * 加载测试音频 - 解码并重采样到16kHz (在预取I/O线程中执行)
+ * 
+ * 🆕 经由进程级解码缓存，预检查与各测试阶段重复使用同一份PCM
+ */
+AudioFileReader::AudioDataPtr FunASREngine::LoadTestAudio(const std::string& file_path) {
+    if (packed_corpus_) {
+        auto it = corpus_index_.find(file_path);
+        if (it == corpus_index_.end()) {
+            return std::make_shared<const AudioFileReader::AudioData>();
+        }
+        return std::make_shared<const AudioFileReader::AudioData>(packed_corpus_->ToAudioData(it->second));
     }
+    
+    const int target_rate = config_.enable_audio_resampling ? 16000 : 0;
+    return AudioCache::Instance().GetOrLoad(file_path, target_rate, [&file_path, target_rate]() {
+        auto audio_data = AudioFileReader::ReadWavFile(file_path);
+        if (audio_data.IsValid() && target_rate > 0 && audio_data.sample_rate != target_rate) {
+            audio_data.samples = AudioFileReader::Resample(audio_data.samples, audio_data.sample_rate, target_rate);
+            audio_data.sample_rate = target_rate;
+        }
+        return audio_data;
+    });
+}
+
+std::unique_ptr<AudioPrefetcher> FunASREngine::CreatePrefetcher(std::vector<std::string> files, int io_threads) {
+    return std::make_unique<AudioPrefetcher>(
+        std::move(files),
+        [this](const std::string& path) { return LoadTestAudio(path); },
+        io_threads,
+        static_cast<size_t>(config_.prefetch_queue_size));
 }
 
 std::vector<std::vector<float>> FunASREngine::SimulateStreamingChunks(
@@ -1158,8 +2373,47 @@ std::vector<std::vector<float>> FunASREngine::SimulateStreamingChunks(
  * 🔄 修复说明：将GetGPUMemoryUsage()改为GetCPUMemoryUsage()
  */
 PerformanceMetrics FunASREngine::GetPerformanceMetrics() const {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    auto metrics = current_metrics_;
+    PerformanceMetrics metrics;
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        metrics = current_metrics_;
+    }
+    // 🆕 合并热路径的分片指标 (只做原子读取，不阻塞识别线程)
+    metrics.total_requests = live_metrics_.total_requests.Sum();
+    metrics.success_requests = live_metrics_.success_requests.Sum();
+    metrics.total_audio_processed_hours += live_metrics_.audio_processed_us.Sum() / 1e6 / 3600.0;
+    metrics.offline_latency = live_metrics_.offline_latency.Snapshot();
+    metrics.streaming_latency = live_metrics_.streaming_latency.Snapshot();
+    metrics.two_pass_latency = live_metrics_.two_pass_latency.Snapshot();
+    metrics.vad_latency = live_metrics_.vad_latency.Snapshot();
+    metrics.punctuation_latency = live_metrics_.punctuation_latency.Snapshot();
+    metrics.offline_rtf = live_metrics_.offline_rtf.load(std::memory_order_relaxed);
+    metrics.streaming_rtf = live_metrics_.streaming_rtf.load(std::memory_order_relaxed);
+    metrics.two_pass_rtf = live_metrics_.two_pass_rtf.load(std::memory_order_relaxed);
+    metrics.online_latency_ms = live_metrics_.online_latency_ms.load(std::memory_order_relaxed);
+    metrics.end_to_end_latency_ms = live_metrics_.end_to_end_latency_ms.load(std::memory_order_relaxed);
+    metrics.vad_processing_ms = live_metrics_.vad_processing_ms.load(std::memory_order_relaxed);
+    metrics.punctuation_ms = live_metrics_.punctuation_ms.load(std::memory_order_relaxed);
+    metrics.rolling_windows = live_metrics_.window.Snapshot();
+    if (vad_stage_) {
+        metrics.pipeline_vad_queue = vad_stage_->GetStats().avg_queued;
+        auto asr = asr_stage_->GetStats();
+        metrics.pipeline_asr_queue = asr.avg_queued;
+        metrics.pipeline_asr_batch = asr.AvgBatch();
+        metrics.pipeline_punc_queue = punc_stage_->GetStats().avg_queued;
+    }
+    if (refinement_queue_) {
+        auto refinement = refinement_queue_->GetStats();
+        metrics.refinement_queue_ms = refinement.avg_wait_ms;
+        metrics.offline_refinement_ms = refinement.avg_latency_ms;
+        metrics.refinement_max_latency_ms = refinement.max_latency_ms;
+        metrics.refinement_dropped = refinement.dropped;
+    }
+    auto stages = stage_profiler_.Snapshot();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (stages[i].Count() == 0) continue;
+        metrics.stage_latency.emplace_back(StageProfiler::StageName(static_cast<StageProfiler::Stage>(i)), stages[i]);
+    }
     // 修正：调用正确的CPU内存获取方法
     metrics.gpu_memory_gb = const_cast<FunASREngine*>(this)->GetCPUMemoryUsage();
     return metrics;
@@ -1176,16 +2430,31 @@ PerformanceMetrics FunASREngine::GetPerformanceMetrics() const {
  * 4. 修复日志格式化问题
  */
 bool FunASREngine::LoadTestAudioFiles() {
-    std::ostringstream scan_log;
-    scan_log << "扫描测试音频文件目录: " << config_.audio_files_dir;
-    Logger::Info(scan_log.str());
-    
-    // 扫描WAV文件
-    auto all_wav_files = AudioFileReader::ScanWavFiles(config_.audio_files_dir);
-    if (all_wav_files.empty()) {
-        std::string error_msg = "未找到WAV音频文件，请检查目录: " + config_.audio_files_dir;
-        Logger::Error(error_msg);
-        return false;
+    std::vector<std::string> all_wav_files;
+    if (!config_.packed_corpus_path.empty()) {
+        // 打包语料: 条目ID代替文件路径
+        if (!LoadPackedCorpus(all_wav_files)) {
+            return false;
+        }
+    } else {
+        std::ostringstream scan_log;
+        scan_log << "扫描测试音频文件目录: " << config_.audio_files_dir;
+        Logger::Info(scan_log.str());
+        
+        // 构建语料清单 (只读头部，带磁盘缓存)，记录时长用于均衡调度
+        CorpusManifest manifest;
+        if (manifest.Build(config_.audio_files_dir, config_.manifest_threads, config_.manifest_cache_path)) {
+            for (const auto& entry : manifest.Entries()) {
+                if (!entry.IsUsable()) continue;
+                all_wav_files.push_back(entry.path);
+                test_audio_durations_[entry.path] = entry.duration_seconds;
+            }
+        }
+        if (all_wav_files.empty()) {
+            std::string error_msg = "未找到WAV音频文件，请检查目录: " + config_.audio_files_dir;
+            Logger::Error(error_msg);
+            return false;
+        }
     }
     
     // 选择测试文件 (如果文件太多，随机选择一部分)
@@ -1211,8 +2480,8 @@ bool FunASREngine::LoadTestAudioFiles() {
     // 预检查几个文件确保可读性
     int valid_files = 0;
     for (int i = 0; i < std::min(5, static_cast<int>(test_audio_files_.size())); ++i) {
-        auto audio_data = AudioFileReader::ReadWavFile(test_audio_files_[i]);
-        if (audio_data.IsValid()) {
+        auto audio_data = LoadTestAudio(test_audio_files_[i]);
+        if (audio_data->IsValid()) {
             valid_files++;
         }
     }
@@ -1230,14 +2499,68 @@ bool FunASREngine::LoadTestAudioFiles() {
 }
 
 
+/**
+ * 加载打包语料 - 只取本分片 (按总时长均衡) 的条目
+ */
+bool FunASREngine::LoadPackedCorpus(std::vector<std::string>& entry_ids) {
+    packed_corpus_ = std::make_unique<PackedCorpus>();
+    if (!packed_corpus_->Open(config_.packed_corpus_path)) {
+        packed_corpus_.reset();
+        return false;
+    }
+    
+    auto range = packed_corpus_->ShardRange(config_.corpus_shard_index, config_.corpus_shard_count);
+    for (size_t i = range.first; i < range.second; ++i) {
+        const auto& entry = packed_corpus_->GetEntry(i);
+        corpus_index_[entry.id] = i;
+        test_audio_durations_[entry.id] = entry.duration_seconds;
+        entry_ids.push_back(entry.id);
+    }
+    
+    std::ostringstream shard_log;
+    shard_log << "打包语料分片 " << config_.corpus_shard_index << "/" << config_.corpus_shard_count
+              << ": 条目[" << range.first << ", " << range.second << ")";
+    Logger::Info(shard_log.str());
+    
+    if (entry_ids.empty()) {
+        Logger::Error("打包语料分片为空: {}", config_.packed_corpus_path);
+        return false;
+    }
+    return true;
+}
+
+double FunASREngine::GetTestAudioDuration(const std::string& key) const {
+    auto it = test_audio_durations_.find(key);
+    return it == test_audio_durations_.end() ? 0.0 : it->second;
+}
+
 void FunASREngine::UpdateMetrics(const PerformanceMetrics& new_metrics) {
+    // 测试得出的RTF/延迟覆盖热路径的"最近一次"值 (与识别线程写同一组原子变量，后写者生效)
+    if (new_metrics.streaming_rtf > 0) live_metrics_.streaming_rtf.store(new_metrics.streaming_rtf, std::memory_order_relaxed);
+    if (new_metrics.offline_rtf > 0) live_metrics_.offline_rtf.store(new_metrics.offline_rtf, std::memory_order_relaxed);
+    if (new_metrics.two_pass_rtf > 0) live_metrics_.two_pass_rtf.store(new_metrics.two_pass_rtf, std::memory_order_relaxed);
+    if (new_metrics.end_to_end_latency_ms > 0) {
+        live_metrics_.end_to_end_latency_ms.store(new_metrics.end_to_end_latency_ms, std::memory_order_relaxed);
+    }
+    if (new_metrics.online_latency_ms > 0) {
+        live_metrics_.online_latency_ms.store(new_metrics.online_latency_ms, std::memory_order_relaxed);
+    }
+    
     std::lock_guard<std::mutex> lock(metrics_mutex_);
     // 实际更新逻辑，按字段分别处理
-    if (new_metrics.streaming_rtf > 0) current_metrics_.streaming_rtf = new_metrics.streaming_rtf;
-    if (new_metrics.offline_rtf > 0) current_metrics_.offline_rtf = new_metrics.offline_rtf;
-    if (new_metrics.two_pass_rtf > 0) current_metrics_.two_pass_rtf = new_metrics.two_pass_rtf;
-    if (new_metrics.end_to_end_latency_ms > 0) current_metrics_.end_to_end_latency_ms = new_metrics.end_to_end_latency_ms;
-    if (new_metrics.online_latency_ms > 0) current_metrics_.online_latency_ms = new_metrics.online_latency_ms;
+    if (!new_metrics.capacity_bottleneck.empty()) {
+        current_metrics_.capacity_max_sessions = new_metrics.capacity_max_sessions;
+        current_metrics_.capacity_bottleneck = new_metrics.capacity_bottleneck;
+    }
+    if (!new_metrics.open_loop_curve.empty()) current_metrics_.open_loop_curve = new_metrics.open_loop_curve;
+    if (new_metrics.paced_sessions > 0) {
+        current_metrics_.paced_sessions = new_metrics.paced_sessions;
+        current_metrics_.paced_rtf = new_metrics.paced_rtf;
+        current_metrics_.paced_latency_p50_ms = new_metrics.paced_latency_p50_ms;
+        current_metrics_.paced_latency_p95_ms = new_metrics.paced_latency_p95_ms;
+        current_metrics_.paced_latency_p99_ms = new_metrics.paced_latency_p99_ms;
+        current_metrics_.paced_queue_p99_ms = new_metrics.paced_queue_p99_ms;
+    }
     if (new_metrics.concurrent_sessions > 0) current_metrics_.concurrent_sessions = new_metrics.concurrent_sessions;
     if (new_metrics.total_audio_processed_hours > 0) current_metrics_.total_audio_processed_hours += new_metrics.total_audio_processed_hours;
     if (new_metrics.test_files_count > 0) current_metrics_.test_files_count = new_metrics.test_files_count;
@@ -1246,9 +2569,9 @@ void FunASREngine::UpdateMetrics(const PerformanceMetrics& new_metrics) {
     // 修复：日志格式（标准 C++ 流式拼接，保证输出内容清晰）
     std::ostringstream oss;
     oss << "更新性能指标："
-        << "流式RTF=" << std::fixed << std::setprecision(4) << current_metrics_.streaming_rtf << ", "
-        << "离线RTF=" << std::fixed << std::setprecision(4) << current_metrics_.offline_rtf << ", "
-        << "2PassRTF=" << std::fixed << std::setprecision(4) << current_metrics_.two_pass_rtf << ", "
+        << "流式RTF=" << std::fixed << std::setprecision(4) << live_metrics_.streaming_rtf.load() << ", "
+        << "离线RTF=" << std::fixed << std::setprecision(4) << live_metrics_.offline_rtf.load() << ", "
+        << "2PassRTF=" << std::fixed << std::setprecision(4) << live_metrics_.two_pass_rtf.load() << ", "
         << "并发=" << current_metrics_.concurrent_sessions << ", "
         << "总时长=" << std::fixed << std::setprecision(1) << current_metrics_.total_audio_processed_hours << "h";
     Logger::Info(oss.str());
@@ -4,14 +4,31 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <functional>
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <future>
 #include <pybind11/pybind11.h>
 #include <pybind11/embed.h>
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include "utils.h"
+#include "audio_prefetcher.h"
+#include "audio_cache.h"
+#include "packed_corpus.h"
+#include "corpus_manifest.h"
+#include "work_stealing_pool.h"
+#include "task_executor.h"
+#include "refinement_queue.h"
+#include "pipeline_stage.h"
+#include "session_manager.h"
+#include "chunk_size_controller.h"
+#include "open_loop_generator.h"
+#include "stage_profiler.h"
+#include "sharded_metrics.h"
+#include "metrics_server.h"
 
 namespace py = pybind11;
 
@@ -51,6 +68,7 @@ public:
         // 2Pass模式专用字段
         bool is_online_result = false;        // 是否为在线结果
         bool is_offline_result = false;       // 是否为离线精化结果
+        bool is_dropped = false;              // 🆕 精化队列已满，该语音段没有离线结果
         
         bool IsEmpty() const { return text.empty(); }
     };
@@ -68,20 +86,43 @@ public:
         bool HasValidSegments() const { return !segments.empty(); }
     };
     
+    /**
+     * 🆕 模型调用的Python侧持久状态 (访问和释放均需持有GIL)
+     * 
+     * cache_dict 直接作为generate的cache参数传入，FunASR原地更新，跨调用保留；
+     * kwargs 首次调用时构建固定参数，之后每次只替换input等少数键，
+     * 不再在std::map与py::dict之间来回拷贝和转换字符串键。
+     */
+    struct PyModelCache {
+        py::object cache_dict;                // 模型内部缓存 (py::dict)
+        py::object kwargs;                    // 复用的调用参数 (py::dict，含cache)
+        
+        bool IsEmpty() const { return !cache_dict && !kwargs; }
+        void Clear() {
+            cache_dict = py::object();
+            kwargs = py::object();
+        }
+    };
+    
     /**
      * 2Pass会话状态 (保持与GPU版本一致)
      * 对应FunASR WebSocket服务器的会话管理
      */
     struct TwoPassSession {
         // 流式状态 (对应FunASR streaming cache)
-        std::map<std::string, py::object> streaming_cache;
-        std::map<std::string, py::object> vad_cache;
-        std::map<std::string, py::object> punc_cache;
+        PyModelCache streaming_cache;
+        PyModelCache vad_cache;
+        PyModelCache punc_cache;
         
         // 音频缓冲区
-        std::vector<float> audio_buffer;      // 完整音频缓冲
+        AudioRingBuffer audio_buffer;  // 🆕 上次定稿后的音频 (含预滚动)，容量由会话池按配置设定
+        uint64_t segment_overwritten = 0;          // 🆕 当前语音段中被缓冲覆盖的样本数
         std::vector<float> current_segment;   // 当前语音段
         
+        // 🆕 会话ID (OpenSession时设置) 与已处理分块数，用于追踪事件
+        std::string id;
+        uint64_t chunk_index = 0;
+        
         // 状态控制 (对应FunASR WebSocket协议)
         bool is_speaking = false;             // 是否正在说话
         bool is_final = false;                // 是否结束
@@ -93,16 +134,157 @@ public:
         int decoder_chunk_look_back = 1;     // 解码器回看块数
         int chunk_interval = 10;             // 分块间隔
         
+        // 🆕 离线精化结果通道 (精化任务持有共享引用，不再引用会话本身)
+        std::shared_ptr<RefinementSink> refinement = std::make_shared<RefinementSink>();
+        
+        // 🆕 最近活动时间 (steady_clock计数)，会话管理器据此淘汰空闲会话
+        std::atomic<std::chrono::steady_clock::rep> last_activity{
+            std::chrono::steady_clock::now().time_since_epoch().count()};
+        
+        TwoPassSession() = default;
+        TwoPassSession(const TwoPassSession&) = delete;
+        TwoPassSession& operator=(const TwoPassSession&) = delete;
+        
+        // 缓存中持有Python对象，析构时必须持有GIL释放引用；先解除回调，之后完成的精化不再回调
+        ~TwoPassSession() {
+            refinement->SetCallback(nullptr);
+            ClearPythonCaches();
+        }
+        
+        /**
+         * 🆕 设置离线精化结果回调 - 在精化线程中按语音段顺序调用
+         * 未设置回调时结果进入完成队列，通过TakeFinalResults取出
+         */
+        void SetFinalResultCallback(std::function<void(const RecognitionResult&)> callback) {
+            if (!callback) {
+                refinement->SetCallback(nullptr);
+                return;
+            }
+            refinement->SetCallback([callback](const RefinedSegment& segment) {
+                callback(ToFinalResult(segment));
+            });
+        }
+        
+        std::vector<RecognitionResult> TakeFinalResults() {
+            std::vector<RecognitionResult> results;
+            for (const auto& segment : refinement->TakeCompleted()) {
+                results.push_back(ToFinalResult(segment));
+            }
+            return results;
+        }
+        
+        // 等待本会话已提交的语音段全部精化完成
+        void WaitForRefinements() { refinement->WaitIdle(); }
+        
+        static RecognitionResult ToFinalResult(const RefinedSegment& segment) {
+            RecognitionResult result;
+            result.text = segment.text;
+            result.is_final = true;
+            result.is_offline_result = true;
+            result.inference_time_ms = segment.LatencyMs();
+            result.is_dropped = segment.dropped;
+            return result;
+        }
+        
+        void ClearPythonCaches() {
+            if (streaming_cache.IsEmpty() && vad_cache.IsEmpty() && punc_cache.IsEmpty()) {
+                return;
+            }
+            py::gil_scoped_acquire gil;
+            streaming_cache.Clear();
+            vad_cache.Clear();
+            punc_cache.Clear();
+        }
+        
         void Reset() {
-            streaming_cache.clear();
-            vad_cache.clear();
-            punc_cache.clear();
-            audio_buffer.clear();
+            ClearPythonCaches();
+            audio_buffer.Clear();
+            segment_overwritten = 0;
             current_segment.clear();
+            chunk_index = 0;
             is_speaking = false;
             is_final = false;
             vad_pre_idx = 0;
         }
+        
+        // 当前分块时长 (chunk_size[1]为60ms帧数)
+        int ChunkMs() const { return chunk_size[1] * 60; }
+        
+        void Touch() {
+            last_activity.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                                std::memory_order_relaxed);
+        }
+        
+        std::chrono::steady_clock::time_point LastActivity() const {
+            return std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(last_activity.load(std::memory_order_relaxed)));
+        }
+        
+        // 🆕 设置环形音频缓冲容量并立即分配 (会话池创建对象时调用，Reset不释放存储)
+        void Reserve(size_t samples) {
+            audio_buffer.SetCapacity(samples);
+            audio_buffer.Allocate();
+        }
+        
+        /**
+         * 🆕 回池前重置 - 解除回调并换用新的精化通道，
+         * 上一个使用者尚未完成的精化结果不会投递给下一个使用者
+         */
+        void Recycle() {
+            refinement->SetCallback(nullptr);
+            refinement = std::make_shared<RefinementSink>();
+            id.clear();
+            Reset();
+        }
+    };
+    
+    using SessionHandle = std::shared_ptr<TwoPassSession>;
+    using SessionAdmission = SessionManager<TwoPassSession>::Admission;
+    
+    /**
+     * 🆕 按实时节奏的流式压测结果
+     * 
+     * 每个分块的"释放时刻"为会话起点 + 该块末尾的音频时间 (即真实麦克风采完这块的时刻):
+     * - queue_delay: 释放时刻到开始识别 (上一块尚未算完时需等待)
+     * - gil_wait: 本块识别中等待GIL的时间 (与其他会话/引擎任务的争用)
+     * - compute: 本块StreamingRecognize耗时减去gil_wait
+     * - partial_latency: 释放时刻到本块部分结果返回 (用户实际感受到的延迟)
+     */
+    struct PacedStreamingReport {
+        int sessions = 0;                     // 成功打开的模拟会话数
+        int rejected = 0;                     // 准入被拒的会话数
+        uint64_t chunks = 0;                  // 已识别分块总数
+        double audio_seconds = 0.0;           // 送入的音频总时长
+        double wall_seconds = 0.0;            // 压测墙钟时长
+        double rtf = 0.0;                     // (GIL等待 + 计算) 总耗时 / 音频总时长
+        LatencySummary queue_delay;
+        LatencySummary gil_wait;
+        LatencySummary compute;
+        LatencySummary partial_latency;
+    };
+    
+    /**
+     * 🆕 容量搜索的服务目标 (SLO)
+     */
+    struct CapacitySlo {
+        double max_p99_latency_ms = 800.0;    // 部分结果延迟P99上限
+        double max_rtf = 1.0;                 // 计算RTF上限 (>=1表示跟不上实时)
+    };
+    
+    /**
+     * 🆕 容量搜索结果 - 满足SLO的最大并发会话数及达到上限时的瓶颈
+     */
+    struct CapacityReport {
+        struct Probe {
+            int sessions = 0;
+            bool passed = false;
+            PacedStreamingReport result;
+            std::array<double, StageProfiler::kStageCount> stage_p99_ms{};  // 本次探测期间各识别阶段的P99
+        };
+        int max_sessions = 0;                 // 满足SLO的最大会话数 (0表示单会话也不满足)
+        bool hit_ceiling = false;             // 达到搜索上限仍满足SLO (实际容量可能更高)
+        std::string bottleneck;               // 首个不满足SLO的探测点的瓶颈说明 (P99相对单会话增幅最大的阶段)
+        std::vector<Probe> probes;            // 按执行顺序的全部探测
     };
     
     /**
@@ -120,17 +302,70 @@ public:
         int cpu_threads;                          // CPU线程数 (新增)
         bool enable_audio_resampling;             // 启用音频重采样 (新增)
         bool enable_cpu_optimization;             // 启用CPU优化 (新增)
+        int executor_threads;                     // 共享执行器线程数 (0表示与cpu_threads相同)
+        int executor_queue_size;                  // 共享执行器任务队列上限
+        int latency_cpu_share;                    // 低延迟任务 (流式/VAD) 的CPU份额百分比
+        int throughput_aging_ms;                  // 吞吐任务 (离线/精化) 最长排队时间
+        int refinement_workers;                   // 2Pass离线精化并行任务数
+        int refinement_queue_size;                // 2Pass离线精化排队语音段上限
+        bool enable_adaptive_chunking;            // 按负载自适应选择流式分块档位
+        int chunk_min_ms;                         // 自适应分块的延迟下限 (最小分块)
+        int chunk_max_ms;                         // 自适应分块的延迟上限 (最大分块)
         
         // ============ 音频文件配置 (保持不变) ============
         std::string audio_files_dir;              // 音频文件目录
         int max_test_files;                       // 最大测试文件数
+        bool load_test_audio;                     // 初始化时加载测试音频 (转写等非测试模式关闭)
+        int prefetch_io_threads;                  // 测试音频预取I/O线程数
+        int prefetch_queue_size;                  // 预取窗口 (已解码待处理的文件数上限)
+        int audio_cache_mb;                       // 解码音频缓存预算 (MB，0表示禁用)
+        std::string packed_corpus_path;           // 打包语料文件 (非空时替代音频目录)
+        int corpus_shard_index;                   // 打包语料分片序号
+        int corpus_shard_count;                   // 打包语料分片总数
+        int manifest_threads;                     // 构建语料清单的并行线程数
+        std::string manifest_cache_path;          // 语料清单缓存文件 (空表示音频目录下默认文件)
         
         // ============ 测试配置 (并发能力提升) ============
         bool enable_offline_test;                 // 启用离线识别测试
         bool enable_streaming_test;               // 启用流式识别测试
         bool enable_two_pass_test;                // 启用2Pass模式测试
         bool enable_concurrent_test;              // 启用并发测试
-        int max_concurrent_sessions;              // 最大并发数 (4→16)
+        int max_concurrent_sessions;              // 最大并发数 (4→16)，同时也是会话管理器的打开会话上限
+        int session_pool_size;                    // 启动时预分配的会话对象数
+        int session_idle_timeout_ms;              // 会话空闲超时 (0表示不淘汰)
+        int session_buffer_seconds;               // 会话环形音频缓冲时长 (不含预滚动)
+        int two_pass_preroll_ms;                  // 2Pass语音段起点前保留的音频
+        bool enable_paced_test;                   // 启用实时节奏流式压测
+        int paced_sessions;                       // 实时节奏压测的模拟会话数 (0表示max_concurrent_sessions)
+        int paced_stagger_ms;                     // 相邻模拟会话的启动间隔
+        double paced_max_audio_seconds;           // 每个模拟会话最多送入的音频时长
+        bool enable_open_loop_test;               // 启用开环离线压测
+        std::vector<double> open_loop_rates;      // 开环压测的各档到达速率 (请求/秒，空表示默认档位或轨迹原始速率)
+        int open_loop_requests;                   // 每档负载提交的请求数
+        int open_loop_workers;                    // 开环压测处理请求的工作线程数
+        std::string arrival_trace_path;           // 到达轨迹文件 (非空时替代泊松到达)
+        uint32_t open_loop_seed;                  // 泊松到达的随机种子 (固定以便复现)
+        std::string trace_output_path;            // Chrome追踪文件 (空表示不追踪)
+        int trace_buffer_events;                  // 每个线程的追踪事件缓冲上限
+        int metrics_port;                         // Prometheus指标端口 (仅监听127.0.0.1，0表示不启用)
+        bool enable_capacity_search;              // 启用容量搜索 (最大可持续并发会话数)
+        double slo_p99_latency_ms;                // 容量搜索SLO: 部分结果延迟P99上限
+        double slo_max_rtf;                       // 容量搜索SLO: 计算RTF上限
+        int capacity_max_sessions;                // 容量搜索上限 (0表示max_concurrent_sessions)
+        double capacity_probe_seconds;            // 每个探测点每路会话的音频时长
+        
+        // ============ 长音频配置 (VAD分段并行识别) ============
+        int long_audio_workers;                   // 长音频分段并行识别的工作线程数
+        double long_audio_min_seconds;            // 超过该时长才启用VAD分段
+        int long_audio_block_ms;                  // 长音频文件分块读取时长 (毫秒)
+        
+        // ============ 流水线配置 (VAD → ASR → 标点 分阶段并行) ============
+        bool enable_pipeline;                     // 离线测试走分阶段流水线
+        int pipeline_vad_workers;                 // 预处理/VAD阶段线程数
+        int pipeline_asr_workers;                 // ASR阶段线程数
+        int pipeline_punc_workers;                // 标点阶段线程数
+        int pipeline_queue_size;                  // 每个阶段的队列上限
+        int pipeline_max_batch;                   // ASR阶段单次推理的最大语音段数
         
         // ============ FunASR模型配置 (保持不变) ============
         std::string streaming_model;              // 流式ASR模型路径
@@ -157,10 +392,26 @@ public:
             cpu_threads(std::thread::hardware_concurrency()), // 🆕 自动检测CPU核数
             enable_audio_resampling(true),        // 🆕 启用音频重采样 (解决24kHz问题)
             enable_cpu_optimization(true),        // 🆕 启用CPU性能优化
+            executor_threads(0),                  // 🆕 共享执行器线程数跟随CPU核数
+            executor_queue_size(1024),            // 🆕 最多排队1024个任务
+            latency_cpu_share(80),                // 🆕 繁忙时流式/VAD占80% CPU
+            throughput_aging_ms(1000),            // 🆕 精化最多被推迟1秒
+            refinement_workers(2),                // 🆕 最多2个语音段同时精化
+            refinement_queue_size(64),            // 🆕 超过64段排队时丢弃精化
+            enable_adaptive_chunking(false),      // 🆕 默认固定600ms分块
+            chunk_min_ms(300),
+            chunk_max_ms(960),
             
             // 音频文件配置 (保持不变)
             audio_files_dir("./audio_files"),
             max_test_files(100),
+            load_test_audio(true),
+            prefetch_io_threads(2),               // 🆕 后台解码/重采样线程
+            prefetch_queue_size(4),               // 🆕 最多提前解码4个文件
+            audio_cache_mb(1024),                 // 🆕 解码缓存1GB (约9小时16kHz音频)
+            corpus_shard_index(0),
+            corpus_shard_count(1),
+            manifest_threads(8),                  // 🆕 并行读取WAV头部
             
             // 测试配置 (提升并发能力)
             enable_offline_test(true),
@@ -168,6 +419,41 @@ public:
             enable_two_pass_test(true),
             enable_concurrent_test(true),
             max_concurrent_sessions(32),          // 🔄 4 → 16 (CPU可支持更多并发)
+            session_pool_size(8),                 // 🆕 常驻8个预分配会话
+            session_idle_timeout_ms(60000),       // 🆕 60秒无活动关闭会话
+            session_buffer_seconds(30),           // 🆕 保留30秒音频 (与VAD最大语音段一致)
+            two_pass_preroll_ms(300),             // 🆕 语音段前保留300ms
+            enable_paced_test(false),             // 🆕 实时节奏压测按需开启 (耗时与音频时长相当)
+            paced_sessions(0),
+            paced_stagger_ms(200),                // 🆕 会话错开200ms启动，避免分块同时到达
+            paced_max_audio_seconds(60.0),
+            enable_open_loop_test(false),         // 🆕 开环压测按需开启
+            open_loop_rates(),                    // 🆕 泊松默认0.5/1/2/4请求每秒，轨迹默认按原始速率回放
+            open_loop_requests(40),
+            open_loop_workers(4),
+            arrival_trace_path(""),
+            open_loop_seed(42),
+            trace_output_path(""),
+            trace_buffer_events(16384),           // 🆕 约1MB/线程，写满后丢弃新事件
+            metrics_port(0),
+            enable_capacity_search(false),
+            slo_p99_latency_ms(800.0),            // 🆕 部分结果P99 < 800ms
+            slo_max_rtf(1.0),                     // 🆕 计算必须快于实时
+            capacity_max_sessions(0),
+            capacity_probe_seconds(30.0),
+            
+            // 长音频配置
+            long_audio_workers(4),                // 🆕 VAD分段并行识别线程数
+            long_audio_min_seconds(5.0),          // 🆕 大于5秒启用VAD分段
+            long_audio_block_ms(10000),           // 🆕 每次读取10秒音频送入VAD
+            
+            // 流水线配置
+            enable_pipeline(false),
+            pipeline_vad_workers(1),
+            pipeline_asr_workers(2),
+            pipeline_punc_workers(1),
+            pipeline_queue_size(8),
+            pipeline_max_batch(4),
             
             // FunASR模型配置 (保持完全一致)
             streaming_model("iic/speech_paraformer-large_asr_nat-zh-cn-16k-common-vocab8404-online"),
@@ -206,16 +492,120 @@ public:
      * 
      * 流程: 音频预处理 → VAD分段 → ASR识别 → 标点符号恢复
      * 
+     * 长音频开启VAD后，语音段分发到long_audio_workers个线程并行识别，
+     * 按时间轴顺序合并文本后统一添加标点。
+     * 
      * @param audio_data 完整音频数据 (支持24kHz自动重采样到16kHz)
      * @param enable_vad 是否启用VAD分段 (长音频推荐开启)
      * @param enable_punctuation 是否添加标点符号
+     * @param sample_rate 输入音频采样率 (默认沿用24kHz假设)
      */
     RecognitionResult OfflineRecognize(
         const std::vector<float>& audio_data,
         bool enable_vad = false,
-        bool enable_punctuation = true
+        bool enable_punctuation = true,
+        int sample_rate = 24000
     );
 
+    /**
+     * 长音频文件分块转写 - 有界内存版
+     * 
+     * 🆕 适用于数小时的会议录音:
+     * 1. 按long_audio_block_ms分块读取并解码WAV，不整体加载文件
+     * 2. 每块送入流式VAD，语音段结束后立即提交离线识别
+     * 3. 语音段定稿后释放对应音频，峰值内存只与块大小和语音段长度相关
+     * 
+     * @param file_path WAV文件路径 (16位PCM，任意采样率)
+     * @param on_segment 每个语音段定稿后的回调 (按时间轴顺序)
+     * @param enable_punctuation 是否添加标点符号 (按段流式添加)
+     * @param parallel_segments 语音段提交到共享执行器并行识别；调用方已按文件并行时
+     *        (批量转写) 传false，在调用线程中逐段识别，避免两级并行争抢执行器
+     * @return 合并后的完整转写结果
+     */
+    RecognitionResult RecognizeWavFileStreaming(
+        const std::string& file_path,
+        const std::function<void(const RecognitionResult&)>& on_segment = nullptr,
+        bool enable_punctuation = true,
+        bool parallel_segments = true
+    );
+
+    /**
+     * 🆕 流水线离线识别 - 提交后立即返回future
+     * 
+     * 请求依次经过 预处理/VAD → ASR → 标点 三个阶段，每个阶段有独立线程与有界队列，
+     * 多个请求的不同阶段互相重叠；第一阶段队列满时阻塞调用方 (背压)。
+     * 需开启enable_pipeline，长音频按long_audio_min_seconds启用VAD分段。
+     */
+    std::future<RecognitionResult> SubmitPipelined(std::vector<float> audio_data, int sample_rate = 16000);
+
+    /**
+     * 🆕 批量转写 - 工作窃取调度的目录级转写
+     * 
+     * 按清单时长 (LPT) 预分配到各工作线程的队列，空闲线程再从其他队列窃取，
+     * 单个超长文件不会让其余线程空等。短文件整段离线识别，长文件走分块转写。
+     * 
+     * @param audio_dir 音频目录
+     * @param num_workers 并行工作线程数
+     * @param on_result 每个文件完成后的回调 (在工作线程中调用，需自行保证线程安全)
+     * @return 成功转写的文件数
+     */
+    size_t BulkTranscribe(
+        const std::string& audio_dir,
+        int num_workers,
+        const std::function<void(const std::string&, const RecognitionResult&, double)>& on_result
+    );
+
+    /**
+     * 🆕 打开会话 - 从会话池取得预分配的TwoPassSession
+     * 
+     * 打开会话数达到max_concurrent_sessions时返回kCapacityExceeded (error为拒绝原因)，
+     * ID重复时返回kDuplicateId。超过session_idle_timeout_ms未调用识别接口的会话会被自动关闭。
+     */
+    SessionAdmission OpenSession(const std::string& session_id);
+
+    /**
+     * 按ID获取已打开的会话，不存在或已被淘汰时返回nullptr
+     */
+    SessionHandle GetSession(const std::string& session_id) const;
+
+    /**
+     * 关闭会话 - 最后一个句柄释放后会话重置并回到池中
+     */
+    bool CloseSession(const std::string& session_id);
+
+    /**
+     * 🆕 会话下一次送入的分块时长 (毫秒)
+     * 
+     * 开启自适应分块且会话处于语句边界 (流式缓存为空) 时先采用控制器的当前档位；
+     * 调用方应按返回值切分下一块音频，保证分块与流式参数一致。
+     */
+    int StreamingChunkMs(TwoPassSession& session);
+
+    bool IsAdaptiveChunking() const { return chunk_controller_ != nullptr; }
+
+    /**
+     * 🆕 实时节奏流式压测 - 模拟num_sessions路真实麦克风输入
+     * 
+     * 每路会话在独立线程中按音频时间释放分块 (采完一块才送一块)，相邻会话错开stagger_ms启动；
+     * 算得比实时慢时分块在调用方排队，体现为queue_delay与partial_latency上升。
+     * 
+     * @param num_sessions 模拟会话数 (受max_concurrent_sessions准入限制)
+     * @param stagger_ms 相邻会话的启动间隔
+     * @param max_audio_seconds 每路会话最多送入的音频时长 (<=0表示整个文件)
+     */
+    PacedStreamingReport RunPacedStreaming(int num_sessions, int stagger_ms, double max_audio_seconds);
+
+    /**
+     * 🆕 容量搜索 - 逐步加倍实时节奏会话数直到违反SLO，再在最后通过与首次失败之间二分
+     * 
+     * 瓶颈按失败探测点判断: 每个探测前后对阶段分析器取快照，给出P99相对单会话探测增幅最大的
+     * 识别阶段 (如gil_wait、streaming_generate)；排队P99超过GIL等待与计算之和时另注明分块积压。
+     * 
+     * @param max_sessions 搜索上限 (不超过max_concurrent_sessions准入上限)
+     * @param probe_seconds 每个探测点每路会话送入的音频时长
+     */
+    CapacityReport FindMaxSessions(const CapacitySlo& slo, int max_sessions, double probe_seconds);
+
     /**
      * 实时流式识别 - CPU多线程优化版
      * 
@@ -250,11 +640,13 @@ public:
      * @param audio_chunk 音频块数据
      * @param session 2Pass会话状态
      * @param results 输出结果列表 (可能包含多个结果)
+     * @param is_final 输入结束: 收尾流式/VAD并提交未结束的语音段 (可传空块)
      */
     void TwoPassRecognize(
         const std::vector<float>& audio_chunk,
         TwoPassSession& session,
-        std::vector<RecognitionResult>& results
+        std::vector<RecognitionResult>& results,
+        bool is_final = false
     );
 
     /**
@@ -269,8 +661,10 @@ public:
      */
     VADResult DetectVoiceActivity(
         const std::vector<float>& audio_data,
-        std::map<std::string, py::object>& vad_cache,
-        int max_single_segment_time = 30000  // 最大分段时长(毫秒)
+        PyModelCache& vad_cache,
+        int max_single_segment_time = 30000,  // 最大分段时长(毫秒)
+        bool is_final = false,                // 是否最后一块 (流式VAD)
+        int chunk_size_ms = 0                 // 流式VAD块时长，0表示不传递
     );
 
     /**
@@ -285,7 +679,7 @@ public:
      */
     std::string AddPunctuation(
         const std::string& text,
-        std::map<std::string, py::object>& punc_cache
+        PyModelCache& punc_cache
     );
 
     /**
@@ -315,6 +709,15 @@ public:
      */
     bool IsTestingActive() const { return testing_active_; }
 
+    /**
+     * 🆕 流式识别的复用kwargs (调用方需持有GIL)
+     * 
+     * 该缓存首次使用时构建固定参数与持久cache，之后返回同一个dict，调用方只替换input/is_final。
+     * 流式识别与参数封送微基准共用，保证基准测量的就是实际调用路径。
+     */
+    static py::dict StreamingKwargs(PyModelCache& state, const std::vector<int>& chunk_size,
+                                    int encoder_chunk_look_back, int decoder_chunk_look_back);
+
 private:
     Config config_;
     std::atomic<bool> initialized_{false};
@@ -327,13 +730,99 @@ private:
     py::object vad_model_;          // VAD模型
     py::object punc_model_;         // 标点符号模型
     
-    // 性能数据 (保持不变)
+    // 🆕 缓存的绑定generate方法，避免每次调用重新查找属性并创建绑定方法对象
+    py::object streaming_generate_;
+    py::object offline_generate_;
+    py::object vad_generate_;
+    py::object punc_generate_;
+    
+    // 初始化完成后主线程释放GIL，各工作线程按需获取
+    std::unique_ptr<py::gil_scoped_release> gil_release_;
+    
+    // 共享执行器: VAD、语音段识别、离线精化等内部并发任务统一在此执行
+    std::unique_ptr<TaskExecutor> executor_;
+    
+    // 2Pass离线精化队列 (任务在共享执行器上运行)
+    std::unique_ptr<RefinementQueue> refinement_queue_;
+    
+    // 🆕 Prometheus指标HTTP服务 (未配置metrics_port时为空)
+    std::unique_ptr<MetricsServer> metrics_server_;
+    
+    // 会话管理器: 会话池 + 并发上限 + 空闲淘汰
+    std::unique_ptr<SessionManager<TwoPassSession>> session_manager_;
+    
+    // 流式分块自适应控制器 (未开启enable_adaptive_chunking时为空)
+    std::unique_ptr<ChunkSizeController> chunk_controller_;
+    
+    // 流水线请求 - 在各阶段之间传递
+    struct PipelineRequest {
+        std::vector<float> audio;                                   // 预处理后为16kHz
+        int sample_rate = 16000;
+        double audio_seconds = 0.0;                                 // 音频时长 (ASR阶段释放音频后仍可用)
+        std::vector<std::pair<int64_t, int64_t>> segments;          // VAD语音段 [开始ms, 结束ms]
+        std::string text;                                           // ASR合并文本
+        Timer timer;                                                // 提交时开始计时
+        std::promise<RecognitionResult> promise;
+    };
+    using PipelineRequestPtr = std::shared_ptr<PipelineRequest>;
+    
+    // 流水线阶段 (未开启enable_pipeline时为空)
+    std::unique_ptr<PipelineStage<PipelineRequestPtr>> vad_stage_;
+    std::unique_ptr<PipelineStage<PipelineRequestPtr>> asr_stage_;
+    std::unique_ptr<PipelineStage<PipelineRequestPtr>> punc_stage_;
+    
+    // 性能数据: 测试结果 (低频写入，加锁)
     mutable std::mutex metrics_mutex_;
     PerformanceMetrics current_metrics_;
     
+    /**
+     * 🆕 识别热路径上的实时指标 - 分片原子计数与直方图，不加锁
+     *
+     * 计数/直方图按线程分片累加，最近一次的RTF/延迟用原子double直接覆盖，
+     * 滑动窗口按秒分桶原子累加；
+     * GetPerformanceMetrics读取时合并进current_metrics_的副本。
+     */
+    struct LiveMetrics {
+        ShardedCounter total_requests;
+        ShardedCounter success_requests;
+        ShardedCounter audio_processed_us;                           // 已处理音频 (微秒)
+        
+        ShardedHistogram offline_latency;
+        ShardedHistogram streaming_latency;
+        ShardedHistogram two_pass_latency;
+        ShardedHistogram vad_latency;
+        ShardedHistogram punctuation_latency;
+        
+        std::atomic<double> offline_rtf{0.0};
+        std::atomic<double> streaming_rtf{0.0};
+        std::atomic<double> two_pass_rtf{0.0};
+        std::atomic<double> online_latency_ms{0.0};
+        std::atomic<double> end_to_end_latency_ms{0.0};
+        std::atomic<double> vad_processing_ms{0.0};
+        std::atomic<double> punctuation_ms{0.0};
+        
+        // 近期吞吐/RTF/错误率 (1秒~5分钟滑动窗口)
+        RollingWindow window;
+        
+        void AddAudio(double seconds) {
+            if (seconds > 0.0) audio_processed_us.Add(static_cast<uint64_t>(seconds * 1e6));
+        }
+    };
+    LiveMetrics live_metrics_;
+    
+    // 🆕 识别各阶段 (重采样/GIL等待/generate/解析等) 的耗时直方图
+    StageProfiler stage_profiler_;
+    
     // 测试相关 (保持不变)
     std::thread test_thread_;
-    std::vector<std::string> test_audio_files_;  // 测试音频文件列表
+    std::vector<std::string> test_audio_files_;  // 测试音频文件列表 (打包语料时为条目ID)
+    
+    // 打包语料 (mmap)，条目ID → 下标
+    std::unique_ptr<PackedCorpus> packed_corpus_;
+    std::unordered_map<std::string, size_t> corpus_index_;
+    
+    // 测试音频时长 (来自语料清单或打包语料索引)，用于按时长均衡调度
+    std::unordered_map<std::string, double> test_audio_durations_;
 
     // ============ 核心私有方法 - CPU版本适配 ============
 
@@ -365,10 +854,69 @@ private:
     );
 
     /**
-     * C++ vector转numpy数组 - 零拷贝 (保持不变)
+     * C++ vector转numpy数组 - 拷贝数据 (调用方需持有GIL)
+     * 
+     * FunASR的流式缓存会保留输入波形的切片，不能引用调用方的缓冲区
      */
     py::array_t<float> VectorToNumpy(const std::vector<float>& data);
 
+    /**
+     * 音频片段转numpy数组 - 仅拷贝该片段 (调用方需持有GIL)
+     */
+    py::array_t<float> SegmentToNumpy(const float* data, size_t size);
+
+    /**
+     * 长音频VAD分段并行识别
+     * 
+     * 🆕 工作线程从共享下标依次领取语音段，每段只拷贝自身音频，
+     * 结果按段下标写回，保证与时间轴顺序一致。
+     * 
+     * @param audio_data 16kHz音频数据
+     * @param segments VAD语音段 [开始ms, 结束ms]
+     * @return 与segments一一对应的识别文本
+     */
+    std::vector<std::string> RecognizeSegmentsParallel(
+        const std::vector<float>& audio_data,
+        const std::vector<std::pair<int64_t, int64_t>>& segments
+    );
+
+    /**
+     * 会话处于语句边界时采用自适应控制器的当前档位
+     */
+    void ApplyChunkProfile(TwoPassSession& session);
+
+    /**
+     * 流式识别实现 - top_level为false时 (作为2Pass的第一遍) 不计入滑动窗口，
+     * 由外层请求按一次记录
+     */
+    RecognitionResult StreamingRecognizeChunk(
+        const std::vector<float>& audio_chunk,
+        TwoPassSession& session,
+        bool is_final,
+        bool top_level
+    );
+    void LogChunkControllerStats(const std::string& phase) const;
+
+    /**
+     * 单个语音段离线识别 (内部获取GIL)
+     */
+    std::string RecognizeSegment(const float* data, size_t size);
+
+    /**
+     * 🆕 2Pass精化处理函数 - 语音段离线识别 + 标点 (精化队列在执行器线程中调用)
+     */
+    std::string RefineSegment(const float* data, size_t size);
+
+    /**
+     * 🆕 流水线各阶段处理函数
+     * - VAD阶段: 重采样 + 长音频VAD分段 (短音频整段作为一个语音段)
+     * - ASR阶段: 本批所有请求的语音段合并为一次批量generate
+     * - 标点阶段: 添加标点并完成future
+     */
+    void PipelineVADStage(std::vector<PipelineRequestPtr>& batch);
+    void PipelineASRStage(std::vector<PipelineRequestPtr>& batch);
+    void PipelinePuncStage(std::vector<PipelineRequestPtr>& batch);
+
     /**
      * 解析FunASR识别结果 (保持不变)
      */
@@ -428,6 +976,16 @@ private:
      */
     bool LoadTestAudioFiles();
 
+    /**
+     * 查询测试音频时长 (秒)，未知时返回0
+     */
+    double GetTestAudioDuration(const std::string& key) const;
+
+    /**
+     * 加载打包语料中本分片的条目ID
+     */
+    bool LoadPackedCorpus(std::vector<std::string>& entry_ids);
+
     // ============ 性能测试方法 - CPU版本优化 ============
 
     /**
@@ -440,6 +998,17 @@ private:
      */
     PerformanceMetrics TestOfflinePerformance();
 
+    /**
+     * 🆕 流水线离线性能测试 - 全部文件一次提交，统计整体吞吐与各阶段队列占用
+     */
+    PerformanceMetrics TestOfflinePipelinePerformance();
+
+    /**
+     * 🆕 开环离线压测 - 按各档到达速率 (泊松或轨迹缩放) 提交OfflineRecognize请求，
+     * 输出每档的吞吐、排队等待、服务时间与延迟分位数
+     */
+    PerformanceMetrics TestOpenLoopOfflinePerformance();
+
     /**
      * 流式识别性能测试 - CPU版本
      * 
@@ -460,6 +1029,16 @@ private:
      */
     PerformanceMetrics TestTwoPassPerformance();
 
+    /**
+     * 🆕 实时节奏流式压测 - 按配置运行RunPacedStreaming并汇总为性能指标
+     */
+    PerformanceMetrics TestPacedStreamingPerformance();
+
+    /**
+     * 🆕 容量搜索 - 按配置的SLO运行FindMaxSessions并输出每个探测点
+     */
+    PerformanceMetrics TestCapacitySearch();
+
     /**
      * 并发性能测试 - CPU版本重点功能
      * 
@@ -472,20 +1051,41 @@ private:
     PerformanceMetrics TestConcurrentPerformance();
 
     /**
-     * 并发测试工作线程 - CPU线程亲和性优化
+     * 并发测试单个Worker的累计值 (整体RTF = Σcompute_ms / Σaudio_seconds)
+     */
+    struct ConcurrentWorkerTotals {
+        int files = 0;
+        double compute_ms = 0.0;
+        double audio_seconds = 0.0;
+    };
+
+    /**
+     * 并发测试任务 - 在工作窃取线程池中处理单个文件
      * 
-     * 🔄 CPU版本改进:
-     * 1. 可选的CPU核心绑定
-     * 2. 优化线程间资源竞争
-     * 3. 增强异常处理和资源清理
+     * 🔄 按文件粒度调度: 先完成的线程窃取其他线程剩余的文件。
+     * 音频由预取线程加载，每个文件的RTF只计该文件的识别耗时 (不含音频加载)。
+     * 
+     * @param audio 预取完成的音频 (尚未就绪时阻塞等待)
+     * @param totals 本线程的累计耗时与音频时长 (按worker_id独占，无需加锁)
      */
     void ConcurrentTestWorker(
         int worker_id,
-        const std::vector<std::string>& worker_files,
+        const std::string& file_path,
+        std::future<AudioFileReader::AudioDataPtr>& audio,
         std::atomic<int>& active_sessions,
-        std::vector<PerformanceMetrics>& results
+        ConcurrentWorkerTotals& totals
     );
 
+    /**
+     * 加载测试音频 - 解码WAV并按配置重采样到16kHz (打包语料直接从mmap读取)
+     */
+    AudioFileReader::AudioDataPtr LoadTestAudio(const std::string& file_path);
+
+    /**
+     * 创建测试文件预取器 - 后台线程提前执行LoadTestAudio
+     */
+    std::unique_ptr<AudioPrefetcher> CreatePrefetcher(std::vector<std::string> files, int io_threads);
+
     /**
      * 模拟流式音频处理 - 将完整音频分块处理 (保持不变)
      */
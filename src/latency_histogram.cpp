@@ -0,0 +1,91 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+size_t LatencyHistogram::BucketIndex(uint64_t micros) {
+    constexpr uint64_t kSubBuckets = 1ULL << kSubBucketBits;
+    if (micros < 2 * kSubBuckets) return static_cast<size_t>(micros);
+    int exponent = 63 - __builtin_clzll(micros);
+    if (exponent >= kMaxExponent) return kBucketCount - 1;
+    // 最高位之后的kSubBucketBits位决定子桶
+    const int shift = exponent - kSubBucketBits;
+    const size_t sub = static_cast<size_t>((micros >> shift) - kSubBuckets);
+    return (static_cast<size_t>(exponent - kSubBucketBits + 1) << kSubBucketBits) + sub;
+}
+
+double LatencyHistogram::BucketUpperMs(size_t index) {
+    constexpr size_t kSubBuckets = 1ULL << kSubBucketBits;
+    if (index < 2 * kSubBuckets) return (index + 1) / 1000.0;
+    const size_t group = index >> kSubBucketBits;                 // = exponent - kSubBucketBits + 1
+    const size_t sub = index & (kSubBuckets - 1);
+    const int shift = static_cast<int>(group) - 1;
+    const uint64_t upper = static_cast<uint64_t>(kSubBuckets + sub + 1) << shift;
+    return upper / 1000.0;
+}
+
+size_t LatencyHistogram::BucketIndexForMs(double ms) {
+    if (!(ms > 0)) return 0;
+    return BucketIndex(static_cast<uint64_t>(std::min(ms * 1000.0, 1e18)));
+}
+
+void LatencyHistogram::Record(double ms) {
+    if (!(ms > 0)) ms = 0.0;
+    counts_[BucketIndexForMs(ms)]++;
+    count_++;
+    sum_ms_ += ms;
+    max_ms_ = std::max(max_ms_, ms);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBucketCount; ++i) counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ms_ += other.sum_ms_;
+    max_ms_ = std::max(max_ms_, other.max_ms_);
+}
+
+void LatencyHistogram::AddBucketCounts(const std::array<uint64_t, kBucketCount>& counts, double sum_ms, double max_ms) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts_[i] += counts[i];
+        count_ += counts[i];
+    }
+    sum_ms_ += sum_ms;
+    max_ms_ = std::max(max_ms_, max_ms);
+}
+
+void LatencyHistogram::Subtract(const LatencyHistogram& earlier) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        const uint64_t removed = std::min(counts_[i], earlier.counts_[i]);
+        counts_[i] -= removed;
+        count_ -= removed;
+    }
+    sum_ms_ = std::max(0.0, sum_ms_ - earlier.sum_ms_);
+}
+
+void LatencyHistogram::Reset() {
+    counts_.fill(0);
+    count_ = 0;
+    sum_ms_ = 0.0;
+    max_ms_ = 0.0;
+}
+
+double LatencyHistogram::PercentileMs(double q) const {
+    if (count_ == 0) return 0.0;
+    q = std::min(1.0, std::max(0.0, q));
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * count_)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) return std::min(BucketUpperMs(i), max_ms_);
+    }
+    return max_ms_;
+}
+
+std::string LatencyHistogram::ToString() const {
+    std::ostringstream oss;
+    oss << count_ << "次, " << std::fixed << std::setprecision(1) << "P50 " << PercentileMs(0.50)
+        << " / P90 " << PercentileMs(0.90) << " / P99 " << PercentileMs(0.99) << " / P99.9 "
+        << PercentileMs(0.999) << " / 最大" << max_ms_ << "ms";
+    return oss.str();
+}
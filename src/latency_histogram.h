@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * 延迟直方图 - HDR风格的对数分桶，记录每个请求而不保存样本
+ *
+ * 🆕 平均值与"最后一次"无法反映尾延迟，SLA按P99/P99.9考核:
+ * - 以微秒计，每个2倍区间再均分16个子桶，分位数相对误差不超过1/16 (6.25%)
+ * - 32微秒以下逐微秒精确，上限约19小时 (更大的值计入最后一个桶)
+ * - Record为常数时间 (一次位运算定位桶)，Merge逐桶相加，可按模式/线程分别记录再合并
+ *
+ * 本身不加锁，并发记录由调用方同步。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;                    // 每个2倍区间16个子桶
+    static constexpr int kMaxExponent = 36;                     // 上限 2^36微秒
+    static constexpr size_t kBucketCount = static_cast<size_t>(kMaxExponent - kSubBucketBits + 1) << kSubBucketBits;
+
+    /**
+     * 记录一次延迟 (毫秒，负值按0计)
+     */
+    void Record(double ms);
+
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+
+    /**
+     * 减去同一累计直方图的较早快照，得到两次快照之间的分布
+     * (最大值无法按区间还原，保留累计最大值，分位数仍按桶计算)
+     */
+    void Subtract(const LatencyHistogram& earlier);
+
+    /**
+     * 某个延迟值 (毫秒) 所在的桶
+     */
+    static size_t BucketIndexForMs(double ms);
+
+    /**
+     * 累加外部按同样分桶统计的计数 (分片直方图合并用)，计数总数取各桶之和
+     */
+    void AddBucketCounts(const std::array<uint64_t, kBucketCount>& counts, double sum_ms, double max_ms);
+
+    uint64_t Count() const { return count_; }
+    double SumMs() const { return sum_ms_; }
+    double MaxMs() const { return max_ms_; }
+    double MeanMs() const { return count_ > 0 ? sum_ms_ / count_ : 0.0; }
+
+    /**
+     * 分位数 (q取0-1)，返回所在桶的上界 (不超过实际最大值)，偏向保守
+     */
+    double PercentileMs(double q) const;
+
+    /**
+     * 按桶遍历 (导出用): 第index个桶的计数与上界 (毫秒)
+     */
+    uint64_t BucketCount(size_t index) const { return counts_[index]; }
+    static double BucketUpperMs(size_t index);
+
+    // 形如 "1234次, P50 10.2 / P90 15.0 / P99 30.1 / P99.9 45.3 / 最大50.0ms"
+    std::string ToString() const;
+
+private:
+    static size_t BucketIndex(uint64_t micros);
+
+    std::array<uint64_t, kBucketCount> counts_{};
+    uint64_t count_ = 0;
+    double sum_ms_ = 0.0;
+    double max_ms_ = 0.0;
+};
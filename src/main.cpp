@@ -24,6 +24,11 @@
 #include <iomanip>
 #include <sstream>
 #include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
 #include "funasr_engine.h"
 
 // ============ 全局变量和工具函数 ============
@@ -31,6 +36,54 @@
 std::unique_ptr<FunASREngine> g_engine;
 std::atomic<bool> g_shutdown_requested{false};
 
+/**
+ * 运行选项 - 命令行中与引擎配置无关的部分
+ */
+struct RunOptions {
+    std::string report_file = "funasr_cpu_performance_report.txt";  // 性能报告文件
+    std::string transcribe_file;                                    // 分块转写的长音频文件
+    std::string pack_corpus_output;                                 // 打包语料输出文件 (打包后退出)
+    std::string bulk_output;                                        // 批量转写结果文件 (JSONL)
+    int bulk_workers = 0;                                           // 批量转写线程数 (0表示CPU线程数)
+    int bench_marshaling = 0;                                       // 参数封送微基准迭代次数 (运行后退出)
+    
+    // 管道输入模式: 从stdin("-")或命名管道读取原始PCM，结果以NDJSON写到stdout
+    std::string stream_input;                                       // 输入源 ("-" 表示stdin)
+    std::string stream_mode = "streaming";                          // streaming | 2pass
+    std::string input_format = "s16le";                             // s16le | f32le
+    int input_rate = 16000;                                         // 输入采样率
+    int chunk_ms = 600;                                             // 送入引擎的分块时长
+};
+
+// 管道输入模式下NDJSON结果的输出流 (stdout原始描述符)
+FILE* g_json_output = nullptr;
+std::mutex g_json_mutex;  // 2Pass精化结果在精化线程中写出
+
+/**
+ * 检查命令行是否包含指定参数 (在正式解析前决定输出通道)
+ */
+bool HasArgument(int argc, char* argv[], const std::string& name) {
+    for (int i = 1; i < argc; i++) {
+        if (name == argv[i]) return true;
+    }
+    return false;
+}
+
+/**
+ * 管道输入模式下把stdout保留给NDJSON结果
+ * 
+ * 日志、Banner以及Python侧的打印都写入描述符1，
+ * 这里先复制出原始stdout专供结果输出，再把描述符1重定向到stderr。
+ */
+bool ReserveStdoutForJson() {
+    int json_fd = dup(STDOUT_FILENO);
+    if (json_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+        return false;
+    }
+    g_json_output = fdopen(json_fd, "w");
+    return g_json_output != nullptr;
+}
+
 /**
  * 信号处理函数 - 优雅退出
  * 支持 SIGINT (Ctrl+C) 和 SIGTERM 信号
@@ -131,6 +184,23 @@ void PrintHelp(const char* program_name) {
     std::cout << "🔧 设备配置选项:\n";
     std::cout << "  --cpu-threads <N>        设置CPU线程数 (默认: 自动检测)\n";
     std::cout << "  --concurrent <N>         设置最大并发会话数 (默认: 144)\n";
+    std::cout << "  --session-pool <N>       预分配的会话对象数 (默认: 8)\n";
+    std::cout << "  --session-idle-ms <N>    会话空闲超时毫秒数，0为不淘汰 (默认: 60000)\n";
+    std::cout << "  --session-buffer-sec <N> 会话环形音频缓冲时长 (默认: 30)\n";
+    std::cout << "  --preroll-ms <N>         2Pass语音段起点前保留的音频毫秒数 (默认: 300)\n";
+    std::cout << "  --executor-threads <N>   共享执行器线程数 (默认: 与CPU线程数相同)\n";
+    std::cout << "  --executor-queue <N>     共享执行器任务队列上限 (默认: 1024)\n";
+    std::cout << "  --latency-share <P>      繁忙时流式/VAD任务的CPU份额百分比 (默认: 80)\n";
+    std::cout << "  --aging-ms <N>           离线/精化任务最长排队毫秒数，超过后优先执行 (默认: 1000)\n";
+    std::cout << "  --refinement-workers <N> 2Pass离线精化并行任务数 (默认: 2)\n";
+    std::cout << "  --refinement-queue <N>   2Pass离线精化排队语音段上限 (默认: 64)\n";
+    std::cout << "  --pipeline               离线测试使用 VAD→ASR→标点 分阶段流水线\n";
+    std::cout << "  --pipeline-workers <v,a,p> 流水线各阶段线程数 (默认: 1,2,1)\n";
+    std::cout << "  --pipeline-queue <N>     流水线每阶段队列上限 (默认: 8)\n";
+    std::cout << "  --pipeline-batch <N>     ASR阶段单次推理最大语音段数 (默认: 4)\n";
+    std::cout << "  --adaptive-chunk         按负载在300/600/960ms流式分块档位间自适应切换\n";
+    std::cout << "  --chunk-min-ms <N>       自适应分块的延迟下限 (默认: 300)\n";
+    std::cout << "  --chunk-max-ms <N>       自适应分块的延迟上限 (默认: 960)\n";
     std::cout << "  --enable-optimization    启用CPU性能优化 (默认: 开启)\n";
     std::cout << "  --disable-optimization   禁用CPU性能优化\n\n";
     
@@ -138,20 +208,62 @@ void PrintHelp(const char* program_name) {
     std::cout << "  --audio-dir <路径>       音频文件目录 (默认: ./audio_files)\n";
     std::cout << "  --max-files <N>          最大测试文件数 (默认: 100)\n";
     std::cout << "  --enable-resampling      启用音频重采样 (默认: 开启)\n";
-    std::cout << "  --disable-resampling     禁用音频重采样\n\n";
+    std::cout << "  --disable-resampling     禁用音频重采样\n";
+    std::cout << "  --prefetch-threads <N>   测试音频预取I/O线程数 (默认: 2)\n";
+    std::cout << "  --prefetch-queue <N>     预取窗口文件数 (默认: 4)\n";
+    std::cout << "  --audio-cache-mb <N>     解码音频缓存预算MB，0为禁用 (默认: 1024)\n";
+    std::cout << "  --manifest-threads <N>   并行读取WAV头部构建语料清单的线程数 (默认: 8)\n";
+    std::cout << "  --manifest-cache <文件>  语料清单缓存文件 (默认: 音频目录/.funasr_manifest.tsv)\n";
+    std::cout << "  --pack-corpus <文件>     把音频目录打包为mmap语料文件后退出\n";
+    std::cout << "  --corpus <文件>          使用打包语料替代音频目录\n";
+    std::cout << "  --corpus-shard <k/n>     只处理打包语料的第k个分片 (共n片，按时长均衡)\n\n";
+    
+    std::cout << "🎧 长音频选项:\n";
+    std::cout << "  --long-audio-workers <N> VAD分段并行识别线程数 (默认: 4)\n";
+    std::cout << "  --long-audio-min-sec <S> 超过该时长启用VAD分段 (默认: 5)\n";
+    std::cout << "  --transcribe-file <文件> 分块读取并转写长音频文件后退出 (有界内存)\n";
+    std::cout << "  --block-ms <N>           长音频分块读取时长 (默认: 10000)\n";
+    std::cout << "  --bulk-transcribe <文件> 转写音频目录全部文件，结果按行写入JSONL后退出\n";
+    std::cout << "  --bulk-workers <N>       批量转写工作线程数 (默认: CPU线程数)\n";
+    std::cout << "  --bench-marshaling <N>   测量每次generate调用的参数封送开销后退出 (无需模型)\n\n";
+    
+    std::cout << "🔌 管道输入选项:\n";
+    std::cout << "  --stream-input <源>      从stdin(-)或命名管道读取原始PCM，NDJSON结果写到stdout\n";
+    std::cout << "  --stream-mode <模式>     管道识别模式 [streaming|2pass] (默认: streaming)\n";
+    std::cout << "  --input-rate <Hz>        输入采样率 (默认: 16000)\n";
+    std::cout << "  --input-format <格式>    输入采样格式 [s16le|f32le] (默认: s16le)\n";
+    std::cout << "  --chunk-ms <N>           分块时长 (默认: 600)\n\n";
     
     std::cout << "🧪 测试模式选项:\n";
     std::cout << "  --test-all               运行所有测试 (默认)\n";
     std::cout << "  --test-offline-only      仅测试离线识别\n";
     std::cout << "  --test-streaming-only    仅测试流式识别\n";
     std::cout << "  --test-2pass-only        仅测试2Pass模式\n";
-    std::cout << "  --test-concurrent-only   仅测试并发性能\n\n";
+    std::cout << "  --test-concurrent-only   仅测试并发性能\n";
+    std::cout << "  --test-paced             追加实时节奏流式压测 (分块按音频时间释放)\n";
+    std::cout << "  --test-paced-only        仅运行实时节奏流式压测\n";
+    std::cout << "  --paced-sessions <N>     实时节奏压测会话数 (默认: 与最大并发数相同)\n";
+    std::cout << "  --paced-stagger-ms <N>   相邻会话启动间隔 (默认: 200)\n";
+    std::cout << "  --paced-max-sec <S>      每路会话最多送入的音频秒数，0为整个文件 (默认: 60)\n";
+    std::cout << "  --test-open-loop         追加开环离线压测 (按到达速率提交，输出延迟-负载曲线)\n";
+    std::cout << "  --open-loop-rates <r,..> 各档到达速率，请求/秒 (默认: 0.5,1,2,4；轨迹默认原始速率)\n";
+    std::cout << "  --open-loop-requests <N> 每档负载的请求数 (默认: 40)\n";
+    std::cout << "  --open-loop-workers <N>  处理请求的工作线程数 (默认: 4)\n";
+    std::cout << "  --arrival-trace <文件>   到达轨迹 (每行一个到达时刻/秒)，替代泊松到达\n";
+    std::cout << "  --find-capacity          仅运行容量搜索: 加倍+二分实时节奏会话数直到违反SLO\n";
+    std::cout << "  --slo-p99-ms <N>         容量搜索SLO: 部分结果延迟P99上限 (默认: 800)\n";
+    std::cout << "  --slo-rtf <R>            容量搜索SLO: 计算RTF上限 (默认: 1.0)\n";
+    std::cout << "  --capacity-max <N>       容量搜索会话数上限 (默认: 与最大并发数相同)\n";
+    std::cout << "  --capacity-probe-sec <S> 每个探测点每路会话的音频秒数 (默认: 30)\n\n";
     
     std::cout << "📊 输出控制选项:\n";
     std::cout << "  --report-file <文件>     性能报告输出文件 (默认: funasr_cpu_report.txt)\n";
     std::cout << "  --log-level <级别>       日志级别 [DEBUG|INFO|WARN|ERROR] (默认: INFO)\n";
     std::cout << "  --quiet                  静默模式，减少日志输出\n";
-    std::cout << "  --verbose                详细模式，增加调试信息\n\n";
+    std::cout << "  --verbose                详细模式，增加调试信息\n";
+    std::cout << "  --trace-file <文件>      记录请求/阶段/GIL等待区间，退出时写出Chrome追踪JSON (Perfetto可打开)\n";
+    std::cout << "  --trace-buffer <N>       每个线程的追踪事件缓冲上限 (默认: 16384)\n";
+    std::cout << "  --metrics-port <端口>    在127.0.0.1:<端口>/metrics 提供Prometheus格式指标 (默认: 不启用)\n\n";
     
     std::cout << "ℹ️  其他选项:\n";
     std::cout << "  --help, -h               显示此帮助信息\n";
@@ -165,6 +277,8 @@ void PrintHelp(const char* program_name) {
     std::cout << "  " << program_name << " --cpu-threads 8 --audio-dir ./my_audio\n\n";
     std::cout << "  # 仅测试离线识别，启用详细日志\n";
     std::cout << "  " << program_name << " --test-offline-only --verbose\n\n";
+    std::cout << "  # 从网关管道实时识别8kHz音频\n";
+    std::cout << "  gateway | " << program_name << " --stream-input - --input-rate 8000\n\n";
     std::cout << "  # 高并发测试，自定义报告文件\n";
     std::cout << "  " << program_name << " --concurrent 32 --report-file performance.txt\n\n";
     
@@ -192,11 +306,10 @@ void PrintVersion() {
  * @param argc 参数数量
  * @param argv 参数数组
  * @param config 输出配置结构体
- * @param report_file 输出报告文件名
+ * @param options 输出运行选项 (报告文件、运行模式等)
  * @return true表示继续执行，false表示退出程序
  */
-bool ParseCommandLine(int argc, char* argv[], FunASREngine::Config& config, std::string& report_file) {
-    report_file = "funasr_cpu_performance_report.txt"; // 默认报告文件名
+bool ParseCommandLine(int argc, char* argv[], FunASREngine::Config& config, RunOptions& options) {
     
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -235,6 +348,151 @@ bool ParseCommandLine(int argc, char* argv[], FunASREngine::Config& config, std:
                 return false;
             }
         }
+        else if (arg == "--session-pool" && i + 1 < argc) {
+            int pool_size = std::stoi(argv[++i]);
+            if (pool_size >= 0 && pool_size <= 1000) {
+                config.session_pool_size = pool_size;
+            } else {
+                Logger::Error("无效的会话池大小: {}，应在0-1000之间", pool_size);
+                return false;
+            }
+        }
+        else if (arg == "--session-idle-ms" && i + 1 < argc) {
+            int idle_ms = std::stoi(argv[++i]);
+            if (idle_ms >= 0 && idle_ms <= 86400000) {
+                config.session_idle_timeout_ms = idle_ms;
+            } else {
+                Logger::Error("无效的会话空闲超时: {}，应在0-86400000毫秒之间", idle_ms);
+                return false;
+            }
+        }
+        else if (arg == "--session-buffer-sec" && i + 1 < argc) {
+            int seconds = std::stoi(argv[++i]);
+            if (seconds >= 1 && seconds <= 600) {
+                config.session_buffer_seconds = seconds;
+            } else {
+                Logger::Error("无效的会话音频缓冲时长: {}，应在1-600秒之间", seconds);
+                return false;
+            }
+        }
+        else if (arg == "--preroll-ms" && i + 1 < argc) {
+            int preroll_ms = std::stoi(argv[++i]);
+            if (preroll_ms >= 0 && preroll_ms <= 5000) {
+                config.two_pass_preroll_ms = preroll_ms;
+            } else {
+                Logger::Error("无效的预滚动时长: {}，应在0-5000毫秒之间", preroll_ms);
+                return false;
+            }
+        }
+        else if (arg == "--executor-threads" && i + 1 < argc) {
+            int threads = std::stoi(argv[++i]);
+            if (threads > 0 && threads <= 256) {
+                config.executor_threads = threads;
+            } else {
+                Logger::Error("无效的执行器线程数: {}，应在1-256之间", threads);
+                return false;
+            }
+        }
+        else if (arg == "--latency-share" && i + 1 < argc) {
+            int share = std::stoi(argv[++i]);
+            if (share >= 1 && share <= 99) {
+                config.latency_cpu_share = share;
+            } else {
+                Logger::Error("无效的低延迟CPU份额: {}，应在1-99之间", share);
+                return false;
+            }
+        }
+        else if (arg == "--aging-ms" && i + 1 < argc) {
+            int aging_ms = std::stoi(argv[++i]);
+            if (aging_ms >= 0 && aging_ms <= 600000) {
+                config.throughput_aging_ms = aging_ms;
+            } else {
+                Logger::Error("无效的吞吐任务排队上限: {}，应在0-600000毫秒之间", aging_ms);
+                return false;
+            }
+        }
+        else if (arg == "--adaptive-chunk") {
+            config.enable_adaptive_chunking = true;
+        }
+        else if (arg == "--chunk-min-ms" && i + 1 < argc) {
+            int chunk_ms = std::stoi(argv[++i]);
+            if (chunk_ms >= 60 && chunk_ms <= 10000) {
+                config.chunk_min_ms = chunk_ms;
+            } else {
+                Logger::Error("无效的分块延迟下限: {}，应在60-10000毫秒之间", chunk_ms);
+                return false;
+            }
+        }
+        else if (arg == "--chunk-max-ms" && i + 1 < argc) {
+            int chunk_ms = std::stoi(argv[++i]);
+            if (chunk_ms >= 60 && chunk_ms <= 10000) {
+                config.chunk_max_ms = chunk_ms;
+            } else {
+                Logger::Error("无效的分块延迟上限: {}，应在60-10000毫秒之间", chunk_ms);
+                return false;
+            }
+        }
+        else if (arg == "--pipeline") {
+            config.enable_pipeline = true;
+        }
+        else if (arg == "--pipeline-workers" && i + 1 < argc) {
+            std::string workers = argv[++i];
+            int vad = 0, asr = 0, punc = 0;
+            if (sscanf(workers.c_str(), "%d,%d,%d", &vad, &asr, &punc) == 3 &&
+                vad > 0 && asr > 0 && punc > 0 && vad <= 64 && asr <= 64 && punc <= 64) {
+                config.pipeline_vad_workers = vad;
+                config.pipeline_asr_workers = asr;
+                config.pipeline_punc_workers = punc;
+            } else {
+                Logger::Error("无效的流水线线程数: {}，格式应为 VAD,ASR,标点 (各1-64)", workers);
+                return false;
+            }
+        }
+        else if (arg == "--pipeline-queue" && i + 1 < argc) {
+            int queue_size = std::stoi(argv[++i]);
+            if (queue_size > 0 && queue_size <= 10000) {
+                config.pipeline_queue_size = queue_size;
+            } else {
+                Logger::Error("无效的流水线队列上限: {}，应在1-10000之间", queue_size);
+                return false;
+            }
+        }
+        else if (arg == "--pipeline-batch" && i + 1 < argc) {
+            int batch = std::stoi(argv[++i]);
+            if (batch > 0 && batch <= 256) {
+                config.pipeline_max_batch = batch;
+            } else {
+                Logger::Error("无效的ASR批大小: {}，应在1-256之间", batch);
+                return false;
+            }
+        }
+        else if (arg == "--refinement-workers" && i + 1 < argc) {
+            int workers = std::stoi(argv[++i]);
+            if (workers > 0 && workers <= 256) {
+                config.refinement_workers = workers;
+            } else {
+                Logger::Error("无效的精化并行数: {}，应在1-256之间", workers);
+                return false;
+            }
+        }
+        else if (arg == "--refinement-queue" && i + 1 < argc) {
+            int queue_size = std::stoi(argv[++i]);
+            if (queue_size > 0 && queue_size <= 100000) {
+                config.refinement_queue_size = queue_size;
+            } else {
+                Logger::Error("无效的精化队列上限: {}，应在1-100000之间", queue_size);
+                return false;
+            }
+        }
+        else if (arg == "--executor-queue" && i + 1 < argc) {
+            int queue_size = std::stoi(argv[++i]);
+            if (queue_size > 0 && queue_size <= 1000000) {
+                config.executor_queue_size = queue_size;
+            } else {
+                Logger::Error("无效的执行器队列上限: {}，应在1-1000000之间", queue_size);
+                return false;
+            }
+        }
         else if (arg == "--enable-optimization") {
             config.enable_cpu_optimization = true;
         }
@@ -268,6 +526,173 @@ bool ParseCommandLine(int argc, char* argv[], FunASREngine::Config& config, std:
             config.enable_audio_resampling = false;
         }
         
+        else if (arg == "--prefetch-threads" && i + 1 < argc) {
+            int threads = std::stoi(argv[++i]);
+            if (threads > 0 && threads <= 64) {
+                config.prefetch_io_threads = threads;
+            } else {
+                Logger::Error("无效的预取线程数: {}，应在1-64之间", threads);
+                return false;
+            }
+        }
+        else if (arg == "--prefetch-queue" && i + 1 < argc) {
+            int queue_size = std::stoi(argv[++i]);
+            if (queue_size > 0 && queue_size <= 1024) {
+                config.prefetch_queue_size = queue_size;
+            } else {
+                Logger::Error("无效的预取窗口: {}，应在1-1024之间", queue_size);
+                return false;
+            }
+        }
+        
+        else if (arg == "--audio-cache-mb" && i + 1 < argc) {
+            int cache_mb = std::stoi(argv[++i]);
+            if (cache_mb >= 0) {
+                config.audio_cache_mb = cache_mb;
+            } else {
+                Logger::Error("无效的缓存预算: {}", cache_mb);
+                return false;
+            }
+        }
+        
+        else if (arg == "--manifest-threads" && i + 1 < argc) {
+            int threads = std::stoi(argv[++i]);
+            if (threads > 0 && threads <= 256) {
+                config.manifest_threads = threads;
+            } else {
+                Logger::Error("无效的清单线程数: {}，应在1-256之间", threads);
+                return false;
+            }
+        }
+        else if (arg == "--manifest-cache" && i + 1 < argc) {
+            config.manifest_cache_path = argv[++i];
+        }
+        else if (arg == "--pack-corpus" && i + 1 < argc) {
+            options.pack_corpus_output = argv[++i];
+        }
+        else if (arg == "--corpus" && i + 1 < argc) {
+            std::string corpus = argv[++i];
+            if (std::filesystem::exists(corpus)) {
+                config.packed_corpus_path = corpus;
+            } else {
+                Logger::Error("打包语料不存在: {}", corpus);
+                return false;
+            }
+        }
+        else if (arg == "--corpus-shard" && i + 1 < argc) {
+            std::string shard = argv[++i];
+            int shard_index = -1, shard_count = 0;
+            if (sscanf(shard.c_str(), "%d/%d", &shard_index, &shard_count) == 2 &&
+                shard_count > 0 && shard_index >= 0 && shard_index < shard_count) {
+                config.corpus_shard_index = shard_index;
+                config.corpus_shard_count = shard_count;
+            } else {
+                Logger::Error("无效的语料分片: {}，格式应为 k/n", shard);
+                return false;
+            }
+        }
+        
+        // 长音频配置
+        else if (arg == "--long-audio-workers" && i + 1 < argc) {
+            int workers = std::stoi(argv[++i]);
+            if (workers > 0 && workers <= 256) {
+                config.long_audio_workers = workers;
+            } else {
+                Logger::Error("无效的长音频线程数: {}，应在1-256之间", workers);
+                return false;
+            }
+        }
+        else if (arg == "--transcribe-file" && i + 1 < argc) {
+            std::string file = argv[++i];
+            if (std::filesystem::exists(file)) {
+                options.transcribe_file = file;
+                config.load_test_audio = false;
+            } else {
+                Logger::Error("音频文件不存在: {}", file);
+                return false;
+            }
+        }
+        else if (arg == "--bulk-transcribe" && i + 1 < argc) {
+            options.bulk_output = argv[++i];
+            config.load_test_audio = false;
+        }
+        else if (arg == "--bench-marshaling" && i + 1 < argc) {
+            int iterations = std::stoi(argv[++i]);
+            if (iterations > 0 && iterations <= 10000000) {
+                options.bench_marshaling = iterations;
+            } else {
+                Logger::Error("无效的微基准迭代次数: {}，应在1-10000000之间", iterations);
+                return false;
+            }
+        }
+        else if (arg == "--bulk-workers" && i + 1 < argc) {
+            int workers = std::stoi(argv[++i]);
+            if (workers > 0 && workers <= 256) {
+                options.bulk_workers = workers;
+            } else {
+                Logger::Error("无效的批量转写线程数: {}，应在1-256之间", workers);
+                return false;
+            }
+        }
+        else if (arg == "--block-ms" && i + 1 < argc) {
+            int block_ms = std::stoi(argv[++i]);
+            if (block_ms >= 100 && block_ms <= 600000) {
+                config.long_audio_block_ms = block_ms;
+            } else {
+                Logger::Error("无效的分块时长: {}，应在100-600000毫秒之间", block_ms);
+                return false;
+            }
+        }
+        else if (arg == "--stream-input" && i + 1 < argc) {
+            options.stream_input = argv[++i];
+            if (options.stream_input != "-" && !std::filesystem::exists(options.stream_input)) {
+                Logger::Error("管道输入源不存在: {}", options.stream_input);
+                return false;
+            }
+            config.load_test_audio = false;
+        }
+        else if (arg == "--stream-mode" && i + 1 < argc) {
+            options.stream_mode = argv[++i];
+            if (options.stream_mode != "streaming" && options.stream_mode != "2pass") {
+                Logger::Error("无效的管道识别模式: {}", options.stream_mode);
+                return false;
+            }
+        }
+        else if (arg == "--input-rate" && i + 1 < argc) {
+            int rate = std::stoi(argv[++i]);
+            if (rate >= 8000 && rate <= 192000) {
+                options.input_rate = rate;
+            } else {
+                Logger::Error("无效的输入采样率: {}", rate);
+                return false;
+            }
+        }
+        else if (arg == "--input-format" && i + 1 < argc) {
+            options.input_format = argv[++i];
+            if (options.input_format != "s16le" && options.input_format != "f32le") {
+                Logger::Error("无效的输入采样格式: {}", options.input_format);
+                return false;
+            }
+        }
+        else if (arg == "--chunk-ms" && i + 1 < argc) {
+            int chunk_ms = std::stoi(argv[++i]);
+            if (chunk_ms >= 60 && chunk_ms <= 10000) {
+                options.chunk_ms = chunk_ms;
+            } else {
+                Logger::Error("无效的分块时长: {}，应在60-10000毫秒之间", chunk_ms);
+                return false;
+            }
+        }
+        else if (arg == "--long-audio-min-sec" && i + 1 < argc) {
+            double min_seconds = std::stod(argv[++i]);
+            if (min_seconds >= 0) {
+                config.long_audio_min_seconds = min_seconds;
+            } else {
+                Logger::Error("无效的长音频时长阈值: {}", min_seconds);
+                return false;
+            }
+        }
+        
         // 测试模式配置
         else if (arg == "--test-all") {
             config.enable_offline_test = true;
@@ -280,29 +705,171 @@ bool ParseCommandLine(int argc, char* argv[], FunASREngine::Config& config, std:
             config.enable_streaming_test = false;
             config.enable_two_pass_test = false;
             config.enable_concurrent_test = false;
+            config.enable_paced_test = false;
+            config.enable_open_loop_test = false;
+            config.enable_capacity_search = false;
         }
         else if (arg == "--test-streaming-only") {
             config.enable_offline_test = false;
             config.enable_streaming_test = true;
             config.enable_two_pass_test = false;
             config.enable_concurrent_test = false;
+            config.enable_paced_test = false;
+            config.enable_open_loop_test = false;
+            config.enable_capacity_search = false;
         }
         else if (arg == "--test-2pass-only") {
             config.enable_offline_test = false;
             config.enable_streaming_test = false;
             config.enable_two_pass_test = true;
             config.enable_concurrent_test = false;
+            config.enable_paced_test = false;
+            config.enable_open_loop_test = false;
+            config.enable_capacity_search = false;
         }
         else if (arg == "--test-concurrent-only") {
             config.enable_offline_test = false;
             config.enable_streaming_test = false;
             config.enable_two_pass_test = false;
             config.enable_concurrent_test = true;
+            config.enable_paced_test = false;
+            config.enable_open_loop_test = false;
+            config.enable_capacity_search = false;
+        }
+        else if (arg == "--test-paced") {
+            config.enable_paced_test = true;
+        }
+        else if (arg == "--test-paced-only") {
+            config.enable_offline_test = false;
+            config.enable_streaming_test = false;
+            config.enable_two_pass_test = false;
+            config.enable_concurrent_test = false;
+            config.enable_paced_test = true;
+            config.enable_open_loop_test = false;
+            config.enable_capacity_search = false;
+        }
+        else if (arg == "--paced-sessions" && i + 1 < argc) {
+            int sessions = std::stoi(argv[++i]);
+            if (sessions >= 0 && sessions <= 1000) {
+                config.paced_sessions = sessions;
+            } else {
+                Logger::Error("无效的实时节奏压测会话数: {}，应在0-1000之间", sessions);
+                return false;
+            }
+        }
+        else if (arg == "--paced-stagger-ms" && i + 1 < argc) {
+            int stagger_ms = std::stoi(argv[++i]);
+            if (stagger_ms >= 0 && stagger_ms <= 60000) {
+                config.paced_stagger_ms = stagger_ms;
+            } else {
+                Logger::Error("无效的会话启动间隔: {}，应在0-60000毫秒之间", stagger_ms);
+                return false;
+            }
+        }
+        else if (arg == "--paced-max-sec" && i + 1 < argc) {
+            double max_seconds = std::stod(argv[++i]);
+            if (max_seconds >= 0) {
+                config.paced_max_audio_seconds = max_seconds;
+            } else {
+                Logger::Error("无效的实时节奏压测音频时长: {}", max_seconds);
+                return false;
+            }
+        }
+        else if (arg == "--find-capacity") {
+            config.enable_offline_test = false;
+            config.enable_streaming_test = false;
+            config.enable_two_pass_test = false;
+            config.enable_concurrent_test = false;
+            config.enable_paced_test = false;
+            config.enable_open_loop_test = false;
+            config.enable_capacity_search = true;
+        }
+        else if (arg == "--slo-p99-ms" && i + 1 < argc) {
+            double p99_ms = std::stod(argv[++i]);
+            if (p99_ms > 0) {
+                config.slo_p99_latency_ms = p99_ms;
+            } else {
+                Logger::Error("无效的P99延迟目标: {}", p99_ms);
+                return false;
+            }
+        }
+        else if (arg == "--slo-rtf" && i + 1 < argc) {
+            double rtf = std::stod(argv[++i]);
+            if (rtf > 0) {
+                config.slo_max_rtf = rtf;
+            } else {
+                Logger::Error("无效的RTF目标: {}", rtf);
+                return false;
+            }
+        }
+        else if (arg == "--capacity-max" && i + 1 < argc) {
+            int max_sessions = std::stoi(argv[++i]);
+            if (max_sessions >= 0 && max_sessions <= 1000) {
+                config.capacity_max_sessions = max_sessions;
+            } else {
+                Logger::Error("无效的容量搜索上限: {}，应在0-1000之间", max_sessions);
+                return false;
+            }
+        }
+        else if (arg == "--capacity-probe-sec" && i + 1 < argc) {
+            double probe_seconds = std::stod(argv[++i]);
+            if (probe_seconds > 0) {
+                config.capacity_probe_seconds = probe_seconds;
+            } else {
+                Logger::Error("无效的探测音频时长: {}", probe_seconds);
+                return false;
+            }
+        }
+        else if (arg == "--test-open-loop") {
+            config.enable_open_loop_test = true;
+        }
+        else if (arg == "--open-loop-rates" && i + 1 < argc) {
+            std::string rates = argv[++i];
+            std::vector<double> parsed;
+            std::stringstream rate_stream(rates);
+            std::string token;
+            bool valid = true;
+            while (std::getline(rate_stream, token, ',')) {
+                try {
+                    double rate = std::stod(token);
+                    if (rate <= 0) valid = false;
+                    parsed.push_back(rate);
+                } catch (const std::exception&) {
+                    valid = false;
+                }
+            }
+            if (valid && !parsed.empty()) {
+                config.open_loop_rates = parsed;
+            } else {
+                Logger::Error("无效的到达速率列表: {}，格式应为逗号分隔的正数", rates);
+                return false;
+            }
+        }
+        else if (arg == "--open-loop-requests" && i + 1 < argc) {
+            int requests = std::stoi(argv[++i]);
+            if (requests > 0 && requests <= 100000) {
+                config.open_loop_requests = requests;
+            } else {
+                Logger::Error("无效的开环请求数: {}，应在1-100000之间", requests);
+                return false;
+            }
+        }
+        else if (arg == "--open-loop-workers" && i + 1 < argc) {
+            int workers = std::stoi(argv[++i]);
+            if (workers > 0 && workers <= 256) {
+                config.open_loop_workers = workers;
+            } else {
+                Logger::Error("无效的开环工作线程数: {}，应在1-256之间", workers);
+                return false;
+            }
+        }
+        else if (arg == "--arrival-trace" && i + 1 < argc) {
+            config.arrival_trace_path = argv[++i];
         }
         
         // 输出控制
         else if (arg == "--report-file" && i + 1 < argc) {
-            report_file = argv[++i];
+            options.report_file = argv[++i];
         }
         else if (arg == "--log-level" && i + 1 < argc) {
             std::string level = argv[++i];
@@ -321,6 +888,27 @@ bool ParseCommandLine(int argc, char* argv[], FunASREngine::Config& config, std:
         else if (arg == "--verbose") {
             Logger::SetLevel(Logger::DEBUG);
         }
+        else if (arg == "--trace-file" && i + 1 < argc) {
+            config.trace_output_path = argv[++i];
+        }
+        else if (arg == "--trace-buffer" && i + 1 < argc) {
+            int events = std::stoi(argv[++i]);
+            if (events > 0 && events <= 10000000) {
+                config.trace_buffer_events = events;
+            } else {
+                Logger::Error("无效的追踪缓冲大小: {}，应在1-10000000之间", events);
+                return false;
+            }
+        }
+        else if (arg == "--metrics-port" && i + 1 < argc) {
+            int port = std::stoi(argv[++i]);
+            if (port > 0 && port <= 65535) {
+                config.metrics_port = port;
+            } else {
+                Logger::Error("无效的指标端口: {}，应在1-65535之间", port);
+                return false;
+            }
+        }
         
         // 未知参数
         else {
@@ -341,8 +929,9 @@ bool ParseCommandLine(int argc, char* argv[], FunASREngine::Config& config, std:
 bool ValidateConfig(const FunASREngine::Config& config) {
     Logger::Info("========== 配置验证 ==========");
     
-    // 检查音频目录
-    if (!std::filesystem::exists(config.audio_files_dir)) {
+    // 检查音频目录 (仅性能测试需要，使用打包语料时不需要)
+    if (config.load_test_audio && config.packed_corpus_path.empty() &&
+        !std::filesystem::exists(config.audio_files_dir)) {
         Logger::Error("音频目录不存在: {}", config.audio_files_dir);
         return false;
     }
@@ -360,9 +949,26 @@ bool ValidateConfig(const FunASREngine::Config& config) {
                     config.max_concurrent_sessions, config.cpu_threads * 4);
     }
     
+    if (config.enable_adaptive_chunking && config.chunk_min_ms > config.chunk_max_ms) {
+        Logger::Error("自适应分块下限({}ms)大于上限({}ms)", config.chunk_min_ms, config.chunk_max_ms);
+        return false;
+    }
+    if (config.enable_adaptive_chunking &&
+        !ChunkSizeController::HasProfileInRange(config.chunk_min_ms, config.chunk_max_ms)) {
+        Logger::Error("自适应分块范围{}-{}ms内没有可用档位 (可选: 300/600/960ms)",
+                      config.chunk_min_ms, config.chunk_max_ms);
+        return false;
+    }
+    
+    if (config.enable_capacity_search && config.capacity_max_sessions > config.max_concurrent_sessions) {
+        Logger::Warn("容量搜索上限({})超过最大并发会话数({})，将按{}路搜索 (可用 --concurrent 提高准入上限)",
+                    config.capacity_max_sessions, config.max_concurrent_sessions, config.max_concurrent_sessions);
+    }
+    
     // 检查至少启用一个测试
-    if (!config.enable_offline_test && !config.enable_streaming_test && 
-        !config.enable_two_pass_test && !config.enable_concurrent_test) {
+    if (config.load_test_audio && !config.enable_offline_test && !config.enable_streaming_test && 
+        !config.enable_two_pass_test && !config.enable_concurrent_test && !config.enable_paced_test &&
+        !config.enable_open_loop_test && !config.enable_capacity_search) {
         Logger::Error("至少需要启用一种测试模式");
         return false;
     }
@@ -375,7 +981,7 @@ bool ValidateConfig(const FunASREngine::Config& config) {
 /**
  * 显示最终配置信息
  */
-void DisplayFinalConfig(const FunASREngine::Config& config, const std::string& report_file) {
+void DisplayFinalConfig(const FunASREngine::Config& config, const RunOptions& options) {
     Logger::Info("========== 最终配置 ==========");
     
     std::ostringstream config_log;
@@ -391,7 +997,47 @@ void DisplayFinalConfig(const FunASREngine::Config& config, const std::string& r
     Logger::Info(config_log.str());
     
     config_log.str("");
-    config_log << "音频目录: " << config.audio_files_dir;
+    config_log << "会话池: 预分配 " << config.session_pool_size << " 个, 空闲超时 "
+               << config.session_idle_timeout_ms << "ms, 音频缓冲 " << config.session_buffer_seconds
+               << "秒 + 预滚动 " << config.two_pass_preroll_ms << "ms";
+    Logger::Info(config_log.str());
+    
+    config_log.str("");
+    config_log << "共享执行器: " << (config.executor_threads > 0 ? config.executor_threads : config.cpu_threads)
+               << " 线程, 队列上限 " << config.executor_queue_size;
+    Logger::Info(config_log.str());
+    
+    config_log.str("");
+    config_log << "QoS调度: 流式/VAD份额 " << config.latency_cpu_share << "%, 精化最长排队 "
+               << config.throughput_aging_ms << "ms";
+    Logger::Info(config_log.str());
+    
+    if (config.enable_pipeline) {
+        config_log.str("");
+        config_log << "识别流水线: VAD " << config.pipeline_vad_workers << " / ASR " << config.pipeline_asr_workers
+                   << " / 标点 " << config.pipeline_punc_workers << " 线程, 队列上限 " << config.pipeline_queue_size
+                   << ", ASR批大小 " << config.pipeline_max_batch;
+        Logger::Info(config_log.str());
+    }
+    
+    if (config.enable_adaptive_chunking) {
+        config_log.str("");
+        config_log << "自适应分块: " << config.chunk_min_ms << "-" << config.chunk_max_ms << "ms";
+        Logger::Info(config_log.str());
+    }
+    
+    config_log.str("");
+    config_log << "2Pass精化: " << config.refinement_workers << " 路并行, 排队上限 "
+               << config.refinement_queue_size << " 段";
+    Logger::Info(config_log.str());
+    
+    config_log.str("");
+    if (config.packed_corpus_path.empty()) {
+        config_log << "音频目录: " << config.audio_files_dir;
+    } else {
+        config_log << "打包语料: " << config.packed_corpus_path << " (分片 "
+                   << config.corpus_shard_index << "/" << config.corpus_shard_count << ")";
+    }
     Logger::Info(config_log.str());
     
     config_log.str("");
@@ -407,15 +1053,79 @@ void DisplayFinalConfig(const FunASREngine::Config& config, const std::string& r
     Logger::Info(config_log.str());
     
     config_log.str("");
-    config_log << "报告文件: " << report_file;
+    config_log << "长音频并行线程: " << config.long_audio_workers << " 个 (>" 
+               << config.long_audio_min_seconds << "秒启用VAD分段)";
+    Logger::Info(config_log.str());
+    
+    config_log.str("");
+    config_log << "报告文件: " << options.report_file;
     Logger::Info(config_log.str());
     
+    if (!config.trace_output_path.empty()) {
+        config_log.str("");
+        config_log << "追踪文件: " << config.trace_output_path << " (每线程" << config.trace_buffer_events << "个事件)";
+        Logger::Info(config_log.str());
+    }
+    
+    if (config.metrics_port > 0) {
+        config_log.str("");
+        config_log << "指标端口: http://127.0.0.1:" << config.metrics_port << "/metrics";
+        Logger::Info(config_log.str());
+    }
+    
+    if (!options.stream_input.empty()) {
+        std::ostringstream mode_log;
+        mode_log << "\n📋 运行模式: 管道输入 (" << options.stream_input << ", " << options.stream_mode
+                 << ", " << options.input_format << "@" << options.input_rate << "Hz, "
+                 << options.chunk_ms << "ms分块)";
+        Logger::Info(mode_log.str());
+        Logger::Info("==============================");
+        return;
+    }
+    if (!options.transcribe_file.empty()) {
+        Logger::Info("\n📋 运行模式: 长音频分块转写 ({})", options.transcribe_file);
+        Logger::Info("==============================");
+        return;
+    }
+    if (!options.bulk_output.empty()) {
+        std::ostringstream mode_log;
+        mode_log << "\n📋 运行模式: 批量转写 (" << config.audio_files_dir << " → " << options.bulk_output
+                 << ", " << (options.bulk_workers > 0 ? options.bulk_workers : config.cpu_threads) << "个工作线程)";
+        Logger::Info(mode_log.str());
+        Logger::Info("==============================");
+        return;
+    }
+    
     // 显示测试计划
     Logger::Info("\n📋 测试计划:");
     if (config.enable_offline_test) Logger::Info("  ✅ 离线识别性能测试");
     if (config.enable_streaming_test) Logger::Info("  ✅ 流式识别性能测试");
     if (config.enable_two_pass_test) Logger::Info("  ✅ 2Pass模式性能测试");
     if (config.enable_concurrent_test) Logger::Info("  ✅ 并发性能测试");
+    if (config.enable_capacity_search) {
+        std::ostringstream capacity_log;
+        capacity_log << "  ✅ 容量搜索 (SLO: P99 < " << config.slo_p99_latency_ms << "ms, RTF < "
+                     << config.slo_max_rtf << ")";
+        Logger::Info(capacity_log.str());
+    }
+    if (config.enable_open_loop_test) {
+        std::ostringstream open_loop_log;
+        open_loop_log << "  ✅ 开环离线压测 (" << config.open_loop_workers << "个工作线程, ";
+        if (config.arrival_trace_path.empty()) {
+            open_loop_log << "泊松到达 "
+                          << (config.open_loop_rates.empty() ? 4 : config.open_loop_rates.size()) << "档)";
+        } else {
+            open_loop_log << "轨迹 " << config.arrival_trace_path << ")";
+        }
+        Logger::Info(open_loop_log.str());
+    }
+    if (config.enable_paced_test) {
+        std::ostringstream paced_log;
+        paced_log << "  ✅ 实时节奏流式压测 ("
+                  << (config.paced_sessions > 0 ? config.paced_sessions : config.max_concurrent_sessions)
+                  << "路, 间隔" << config.paced_stagger_ms << "ms)";
+        Logger::Info(paced_log.str());
+    }
     
     Logger::Info("==============================");
 }
@@ -447,6 +1157,15 @@ void MonitorProgress() {
                             << " | 成功: " << metrics.success_requests << "次\n"
                             << " 离线RTF: " << std::fixed << std::setprecision(4) << metrics.offline_rtf
                             << " | 处理时长: " << std::setprecision(2) << metrics.total_audio_processed_hours << "小时";
+                // 🆕 当前负载看滑动窗口 (10秒/1分钟)，而非启动以来的累计值
+                for (const auto& window : metrics.rolling_windows) {
+                    if (window.seconds != 10 && window.seconds != 60) continue;
+                    progress_log << "\n 近" << window.seconds << "秒: " << std::setprecision(2)
+                                 << window.requests_per_sec << "请求/秒, 音频" << window.audio_speed
+                                 << "秒/秒, RTF 离线/流式/2Pass " << std::setprecision(4) << window.offline_rtf << "/"
+                                 << window.streaming_rtf << "/" << window.two_pass_rtf << ", 错误率"
+                                 << std::setprecision(1) << window.error_rate * 100.0 << "%";
+                }
                 Logger::Info(progress_log.str());
             } else {
                 Logger::Info("📈 等待测试开始... [{}秒]", progress_count * 10);
@@ -462,6 +1181,267 @@ void MonitorProgress() {
 }
 
 
+/**
+ * 打包语料 - 扫描音频目录并写入单个mmap语料文件 (无需加载模型)
+ */
+bool RunPackCorpus(const FunASREngine::Config& config, const std::string& output_path) {
+    auto wav_files = AudioFileReader::ScanWavFiles(config.audio_files_dir);
+    if (wav_files.empty()) {
+        Logger::Error("未找到WAV音频文件: {}", config.audio_files_dir);
+        return false;
+    }
+    return PackedCorpus::Build(wav_files, output_path) > 0;
+}
+
+/**
+ * 参数封送微基准 - 对比每次调用的C++↔Python状态传递开销
+ * 
+ * 旧方式: std::map → 新建py::dict → 调用 → 逐项拷回std::map (键做字符串转换)
+ * 新方式: 持久cache dict + 复用kwargs，每次只替换input/is_final
+ * 被调函数模拟FunASR原地更新cache，两种方式的Python侧开销相同。
+ */
+bool RunMarshalingBenchmark(int iterations) {
+    // 基准自己持有解释器，只能在引擎创建前运行 (引擎初始化时会再创建解释器)
+    if (g_engine || Py_IsInitialized()) {
+        Logger::Error("参数封送微基准需在引擎初始化前单独运行");
+        return false;
+    }
+    py::scoped_interpreter interpreter;
+    py::dict scope;
+    py::exec(R"(
+def fake_generate(**kwargs):
+    cache = kwargs.get("cache")
+    if cache is not None and not cache:
+        for i in range(8):
+            cache["state_%d" % i] = [i]
+    return [{"text": ""}]
+)", py::globals(), scope);
+    py::object generate = scope["fake_generate"];
+    std::vector<float> chunk(9600, 0.0f);  // 600ms @ 16kHz
+    
+    // 旧方式
+    std::map<std::string, py::object> legacy_cache;
+    Timer legacy_timer;
+    for (int i = 0; i < iterations; ++i) {
+        py::dict kwargs;
+        kwargs["input"] = py::array_t<float>(chunk.size(), chunk.data());
+        kwargs["is_final"] = false;
+        kwargs["chunk_size"] = py::make_tuple(0, 10, 5);
+        kwargs["encoder_chunk_look_back"] = 4;
+        kwargs["decoder_chunk_look_back"] = 1;
+        py::dict cache_dict;
+        for (const auto& item : legacy_cache) {
+            cache_dict[py::str(item.first)] = item.second;
+        }
+        kwargs["cache"] = cache_dict;
+        generate(**kwargs);
+        py::dict updated_cache = kwargs["cache"];
+        legacy_cache.clear();
+        for (auto item : updated_cache) {
+            legacy_cache[item.first.cast<std::string>()] = py::reinterpret_borrow<py::object>(item.second);
+        }
+    }
+    double legacy_ms = legacy_timer.ElapsedMs();
+    
+    // 新方式 (与StreamingRecognize相同的kwargs构建路径)
+    FunASREngine::PyModelCache state;
+    const std::vector<int> chunk_size = {0, 10, 5};
+    Timer persistent_timer;
+    for (int i = 0; i < iterations; ++i) {
+        py::dict kwargs = FunASREngine::StreamingKwargs(state, chunk_size, 4, 1);
+        kwargs["input"] = py::array_t<float>(chunk.size(), chunk.data());
+        kwargs["is_final"] = py::bool_(false);
+        generate(**kwargs);
+        kwargs["input"] = py::none();
+    }
+    double persistent_ms = persistent_timer.ElapsedMs();
+    legacy_cache.clear();
+    state.Clear();
+    
+    std::ostringstream bench_log;
+    bench_log << "📏 参数封送微基准 (" << iterations << "次调用, 8项cache):\n"
+              << "  旧方式 (map↔dict拷贝): " << std::fixed << std::setprecision(2)
+              << legacy_ms * 1000.0 / iterations << " us/次\n"
+              << "  新方式 (持久dict+复用kwargs): " << persistent_ms * 1000.0 / iterations << " us/次";
+    Logger::Info(bench_log.str());
+    return true;
+}
+
+/**
+ * 长音频分块转写 - 逐段输出识别结果，最后输出完整文本
+ */
+bool RunTranscribeFile(const std::string& file_path) {
+    Logger::Info("📝 开始分块转写长音频: {}", file_path);
+    int segment_index = 0;
+    auto result = g_engine->RecognizeWavFileStreaming(file_path,
+        [&segment_index](const FunASREngine::RecognitionResult& segment) {
+            std::ostringstream segment_log;
+            segment_log << "语音段 #" << ++segment_index << ": " << segment.text;
+            Logger::Info(segment_log.str());
+        });
+    
+    if (result.IsEmpty()) {
+        Logger::Error("❌ 转写失败或未识别到语音: {}", file_path);
+        return false;
+    }
+    std::cout << "\n" << result.text << std::endl;
+    return true;
+}
+
+/**
+ * 批量转写 - 目录内全部文件由工作窃取线程池并行转写，每个文件一行JSON
+ */
+bool RunBulkTranscribe(const FunASREngine::Config& config, const RunOptions& options) {
+    std::ofstream output(options.bulk_output);
+    if (!output.is_open()) {
+        Logger::Error("无法创建批量转写输出文件: {}", options.bulk_output);
+        return false;
+    }
+    
+    std::mutex output_mutex;
+    const int workers = options.bulk_workers > 0 ? options.bulk_workers : config.cpu_threads;
+    size_t completed = g_engine->BulkTranscribe(config.audio_files_dir, workers,
+        [&output, &output_mutex](const std::string& path, const FunASREngine::RecognitionResult& result,
+                                 double audio_seconds) {
+            std::ostringstream line;
+            line << "{\"file\":\"" << JsonEscape(path) << "\",\"audio_s\":" << std::fixed << std::setprecision(2)
+                 << audio_seconds << ",\"latency_ms\":" << std::setprecision(1) << result.inference_time_ms
+                 << ",\"text\":\"" << JsonEscape(result.text) << "\"}\n";
+            std::lock_guard<std::mutex> lock(output_mutex);
+            output << line.str();
+        });
+    
+    Logger::Info("📄 批量转写结果已保存到: {}", options.bulk_output);
+    return completed > 0;
+}
+
+/**
+ * 输出一行NDJSON识别结果并立即刷新
+ */
+void WriteJsonResult(const char* type, const std::string& mode, int seq, double audio_ms,
+                     const FunASREngine::RecognitionResult& result) {
+    std::ostringstream line;
+    line << "{\"type\":\"" << type << "\",\"mode\":\"" << mode << "\",\"seq\":" << seq
+         << ",\"audio_ms\":" << std::fixed << std::setprecision(0) << audio_ms
+         << ",\"latency_ms\":" << std::setprecision(1) << result.inference_time_ms
+         << ",\"text\":\"" << JsonEscape(result.text) << "\"}\n";
+    const std::string json = line.str();
+    std::lock_guard<std::mutex> lock(g_json_mutex);
+    fwrite(json.data(), 1, json.size(), g_json_output);
+    fflush(g_json_output);
+}
+
+/**
+ * 从描述符读取恰好size字节 (管道可能分多次到达)，返回实际读取字节数
+ */
+size_t ReadFully(int fd, char* buffer, size_t size) {
+    size_t total = 0;
+    while (total < size && !g_shutdown_requested) {
+        ssize_t n = read(fd, buffer + total, size - total);
+        if (n > 0) {
+            total += static_cast<size_t>(n);
+        } else if (n == 0) {
+            break;  // 写端关闭
+        } else if (errno != EINTR) {
+            Logger::Error("读取管道输入失败: {}", strerror(errno));
+            break;
+        }
+    }
+    return total;
+}
+
+/**
+ * 管道输入模式 - 实时读取原始PCM并逐块识别
+ * 
+ * 输入节奏由上游决定，每读满一个分块立即送入引擎，
+ * 部分结果为 "partial"，输入结束时的收尾结果为 "final"。
+ * 2Pass模式下每个语音段的精化结果为 "final"，精化队列已满未能精化的语音段为 "dropped" (无文本)。
+ */
+bool RunStreamInput(const RunOptions& options) {
+    int fd = STDIN_FILENO;
+    if (options.stream_input != "-") {
+        // 命名管道在写端连接前会阻塞在open
+        fd = open(options.stream_input.c_str(), O_RDONLY);
+        if (fd < 0) {
+            Logger::Error("无法打开管道输入: {}", options.stream_input);
+            return false;
+        }
+    }
+    
+    const size_t sample_bytes = options.input_format == "f32le" ? 4 : 2;
+    std::vector<char> raw;
+    std::vector<float> chunk;
+    
+    const std::string session_id = "stream-input";
+    auto admission = g_engine->OpenSession(session_id);
+    if (!admission.Ok()) {
+        Logger::Error("无法打开管道输入会话: {}", admission.error);
+        if (fd != STDIN_FILENO) close(fd);
+        return false;
+    }
+    FunASREngine::TwoPassSession& session = *admission.session;
+    std::vector<FunASREngine::RecognitionResult> two_pass_results;
+    const bool two_pass = options.stream_mode == "2pass";
+    std::atomic<int> seq{0};
+    std::atomic<double> audio_ms{0.0};
+    
+    // 2Pass精化结果一旦完成立即写出，不等待下一块输入
+    if (two_pass) {
+        session.SetFinalResultCallback([&options, &seq, &audio_ms](const FunASREngine::RecognitionResult& result) {
+            WriteJsonResult(result.is_dropped ? "dropped" : "final", options.stream_mode, seq++, audio_ms.load(), result);
+        });
+    }
+    
+    Logger::Info("🔌 管道输入已就绪，等待音频数据...");
+    while (!g_shutdown_requested) {
+        // 自适应分块时每块按会话当前档位读取 (档位只在语句边界变化)
+        const int chunk_ms = g_engine->IsAdaptiveChunking() ? g_engine->StreamingChunkMs(session) : options.chunk_ms;
+        raw.resize(static_cast<size_t>(options.input_rate) * chunk_ms / 1000 * sample_bytes);
+        size_t bytes = ReadFully(fd, raw.data(), raw.size());
+        size_t samples = bytes / sample_bytes;
+        bool is_final = bytes < raw.size();
+        
+        chunk.resize(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            if (sample_bytes == 2) {
+                int16_t value;
+                memcpy(&value, raw.data() + i * 2, 2);
+                chunk[i] = value / 32768.0f;
+            } else {
+                memcpy(&chunk[i], raw.data() + i * 4, 4);
+            }
+        }
+        if (options.input_rate != 16000) {
+            chunk = AudioFileReader::Resample(chunk, options.input_rate, 16000);
+        }
+        audio_ms.store(audio_ms.load() + samples * 1000.0 / options.input_rate);
+        
+        if (two_pass) {
+            // 最后一块也走2Pass: 未结束的语音段在此提交精化，结果经回调以final输出
+            two_pass_results.clear();
+            g_engine->TwoPassRecognize(chunk, session, two_pass_results, is_final);
+            for (const auto& result : two_pass_results) {
+                WriteJsonResult("partial", options.stream_mode, seq++, audio_ms.load(), result);
+            }
+        } else {
+            auto result = g_engine->StreamingRecognize(chunk, session, is_final);
+            if (!result.IsEmpty() || is_final) {
+                WriteJsonResult(is_final ? "final" : "partial", options.stream_mode, seq++, audio_ms.load(), result);
+            }
+        }
+        if (is_final) break;
+    }
+    
+    // 输出尚在精化的语音段后再退出
+    session.WaitForRefinements();
+    session.SetFinalResultCallback(nullptr);
+    g_engine->CloseSession(session_id);
+    
+    if (fd != STDIN_FILENO) close(fd);
+    Logger::Info("🔌 管道输入结束，共处理{}毫秒音频", static_cast<long>(audio_ms.load()));
+    return true;
+}
+
 /**
  * 生成并保存性能报告
  */
@@ -536,6 +1516,12 @@ bool GeneratePerformanceReport(const std::string& report_file) {
  */
 int main(int argc, char* argv[]) {
     try {
+        // 管道输入模式: stdout只输出NDJSON结果，其余输出转到stderr
+        if (HasArgument(argc, argv, "--stream-input") && !ReserveStdoutForJson()) {
+            Logger::Error("无法重定向标准输出");
+            return -1;
+        }
+        
         // 显示程序Banner
         PrintBanner();
         
@@ -544,15 +1530,25 @@ int main(int argc, char* argv[]) {
         
         // 解析命令行参数
         FunASREngine::Config config;
-        std::string report_file;
+        RunOptions options;
         
-        if (!ParseCommandLine(argc, argv, config, report_file)) {
+        if (!ParseCommandLine(argc, argv, config, options)) {
             return 0; // 正常退出（如显示帮助信息）
         }
         
         // 设置日志级别（如果未在命令行指定，使用默认INFO）
         Logger::SetLevel(Logger::INFO);
         
+        // 打包语料模式 (不需要初始化引擎)
+        if (!options.pack_corpus_output.empty()) {
+            return RunPackCorpus(config, options.pack_corpus_output) ? 0 : -1;
+        }
+        
+        // 参数封送微基准 (只需Python解释器，不加载模型)
+        if (options.bench_marshaling > 0) {
+            return RunMarshalingBenchmark(options.bench_marshaling) ? 0 : -1;
+        }
+        
         // 设置信号处理
         signal(SIGINT, SignalHandler);
         signal(SIGTERM, SignalHandler);
@@ -564,7 +1560,7 @@ int main(int argc, char* argv[]) {
         }
         
         // 显示最终配置
-        DisplayFinalConfig(config, report_file);
+        DisplayFinalConfig(config, options);
         
         // 创建和初始化引擎
         Logger::Info("🚀 正在启动FunASR CPU引擎...");
@@ -578,6 +1574,21 @@ int main(int argc, char* argv[]) {
         
         Logger::Info("✅ FunASR CPU引擎初始化成功！");
         
+        // 管道输入模式
+        if (!options.stream_input.empty()) {
+            return RunStreamInput(options) ? 0 : -1;
+        }
+        
+        // 长音频转写模式
+        if (!options.transcribe_file.empty()) {
+            return RunTranscribeFile(options.transcribe_file) ? 0 : -1;
+        }
+        
+        // 批量转写模式
+        if (!options.bulk_output.empty()) {
+            return RunBulkTranscribe(config, options) ? 0 : -1;
+        }
+        
         // 启动性能测试
         Logger::Info("🧪 启动性能测试套件...");
         if (!g_engine->RunPerformanceTests()) {
@@ -589,7 +1600,7 @@ int main(int argc, char* argv[]) {
         MonitorProgress();
         
         // 生成性能报告
-        if (!GeneratePerformanceReport(report_file)) {
+        if (!GeneratePerformanceReport(options.report_file)) {
             Logger::Warn("⚠️  性能报告生成失败，但测试已完成");
         }
         
@@ -0,0 +1,356 @@
+#include "metrics_server.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <netinet/in.h>
+#include <sstream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// 直方图导出的le边界 (毫秒)
+constexpr double kHistogramBoundsMs[] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 30000};
+
+void WriteHistogram(std::ostringstream& oss, const std::string& name, const std::string& label,
+                    const LatencyHistogram& histogram) {
+    // 细分桶按其上界归入第一个不小于它的边界 (偏保守，与PercentileMs一致)
+    constexpr size_t kBounds = sizeof(kHistogramBoundsMs) / sizeof(kHistogramBoundsMs[0]);
+    uint64_t counts[kBounds] = {};
+    size_t bound = 0;
+    for (size_t i = 0; i < LatencyHistogram::kBucketCount && bound < kBounds; ++i) {
+        while (bound < kBounds && LatencyHistogram::BucketUpperMs(i) > kHistogramBoundsMs[bound]) ++bound;
+        if (bound < kBounds) counts[bound] += histogram.BucketCount(i);
+    }
+    uint64_t cumulative = 0;
+    for (size_t b = 0; b < kBounds; ++b) {
+        cumulative += counts[b];
+        oss << name << "_bucket{" << label << ",le=\"" << kHistogramBoundsMs[b] / 1000.0 << "\"} " << cumulative << "\n";
+    }
+    oss << name << "_bucket{" << label << ",le=\"+Inf\"} " << histogram.Count() << "\n";
+    oss << name << "_sum{" << label << "} " << histogram.SumMs() / 1000.0 << "\n";
+    oss << name << "_count{" << label << "} " << histogram.Count() << "\n";
+}
+
+}  // namespace
+
+std::string FormatPrometheusMetrics(const PerformanceMetrics& metrics) {
+    std::ostringstream oss;
+    oss << std::setprecision(10);
+
+    oss << "# HELP funasr_requests_total Recognition requests and streaming chunks handled.\n"
+        << "# TYPE funasr_requests_total counter\n"
+        << "funasr_requests_total " << metrics.total_requests << "\n"
+        << "# HELP funasr_requests_success_total Requests that produced a non-empty result.\n"
+        << "# TYPE funasr_requests_success_total counter\n"
+        << "funasr_requests_success_total " << metrics.success_requests << "\n"
+        << "# HELP funasr_audio_processed_seconds_total Audio processed, in seconds.\n"
+        << "# TYPE funasr_audio_processed_seconds_total counter\n"
+        << "funasr_audio_processed_seconds_total " << metrics.total_audio_processed_hours * 3600.0 << "\n"
+        << "# HELP funasr_refinement_dropped_total 2Pass segments dropped by the refinement queue.\n"
+        << "# TYPE funasr_refinement_dropped_total counter\n"
+        << "funasr_refinement_dropped_total " << metrics.refinement_dropped << "\n";
+
+    oss << "# HELP funasr_last_rtf Real-time factor of the most recent request per mode.\n"
+        << "# TYPE funasr_last_rtf gauge\n"
+        << "funasr_last_rtf{mode=\"offline\"} " << metrics.offline_rtf << "\n"
+        << "funasr_last_rtf{mode=\"streaming\"} " << metrics.streaming_rtf << "\n"
+        << "funasr_last_rtf{mode=\"two_pass\"} " << metrics.two_pass_rtf << "\n"
+        << "# HELP funasr_memory_gigabytes System memory in use.\n"
+        << "# TYPE funasr_memory_gigabytes gauge\n"
+        << "funasr_memory_gigabytes " << metrics.gpu_memory_gb << "\n"
+        << "# HELP funasr_pipeline_queue_depth Time-weighted average queue occupancy per pipeline stage.\n"
+        << "# TYPE funasr_pipeline_queue_depth gauge\n"
+        << "funasr_pipeline_queue_depth{stage=\"vad\"} " << metrics.pipeline_vad_queue << "\n"
+        << "funasr_pipeline_queue_depth{stage=\"asr\"} " << metrics.pipeline_asr_queue << "\n"
+        << "funasr_pipeline_queue_depth{stage=\"punc\"} " << metrics.pipeline_punc_queue << "\n";
+
+    oss << "# HELP funasr_window_requests_per_second Request rate over a rolling window.\n"
+        << "# TYPE funasr_window_requests_per_second gauge\n";
+    for (const auto& window : metrics.rolling_windows) {
+        oss << "funasr_window_requests_per_second{window=\"" << window.seconds << "s\"} " << window.requests_per_sec << "\n";
+    }
+    oss << "# HELP funasr_window_audio_speed Audio seconds processed per wall second over a rolling window.\n"
+        << "# TYPE funasr_window_audio_speed gauge\n";
+    for (const auto& window : metrics.rolling_windows) {
+        oss << "funasr_window_audio_speed{window=\"" << window.seconds << "s\"} " << window.audio_speed << "\n";
+    }
+    oss << "# HELP funasr_window_rtf Compute time over audio time per mode over a rolling window.\n"
+        << "# TYPE funasr_window_rtf gauge\n";
+    for (const auto& window : metrics.rolling_windows) {
+        const std::string label = "window=\"" + std::to_string(window.seconds) + "s\"";
+        oss << "funasr_window_rtf{" << label << ",mode=\"offline\"} " << window.offline_rtf << "\n"
+            << "funasr_window_rtf{" << label << ",mode=\"streaming\"} " << window.streaming_rtf << "\n"
+            << "funasr_window_rtf{" << label << ",mode=\"two_pass\"} " << window.two_pass_rtf << "\n";
+    }
+    oss << "# HELP funasr_window_error_rate Share of requests that failed (exceptions, dropped refinements) over a rolling window.\n"
+        << "# TYPE funasr_window_error_rate gauge\n";
+    for (const auto& window : metrics.rolling_windows) {
+        oss << "funasr_window_error_rate{window=\"" << window.seconds << "s\"} " << window.error_rate << "\n";
+    }
+    oss << "# HELP funasr_window_empty_results Requests that returned no text (e.g. silent chunks) over a rolling window.\n"
+        << "# TYPE funasr_window_empty_results gauge\n";
+    for (const auto& window : metrics.rolling_windows) {
+        oss << "funasr_window_empty_results{window=\"" << window.seconds << "s\"} " << window.empty_results << "\n";
+    }
+
+    oss << "# HELP funasr_latency_seconds Per-request latency by recognition mode.\n"
+        << "# TYPE funasr_latency_seconds histogram\n";
+    WriteHistogram(oss, "funasr_latency_seconds", "mode=\"offline\"", metrics.offline_latency);
+    WriteHistogram(oss, "funasr_latency_seconds", "mode=\"streaming\"", metrics.streaming_latency);
+    WriteHistogram(oss, "funasr_latency_seconds", "mode=\"two_pass\"", metrics.two_pass_latency);
+
+    // VAD与标点是识别阶段而非模式，与分阶段直方图同属一个指标，mode标签只含识别模式
+    oss << "# HELP funasr_stage_seconds Time spent in each recognition stage.\n"
+        << "# TYPE funasr_stage_seconds histogram\n";
+    WriteHistogram(oss, "funasr_stage_seconds", "stage=\"vad\"", metrics.vad_latency);
+    WriteHistogram(oss, "funasr_stage_seconds", "stage=\"punctuation\"", metrics.punctuation_latency);
+    for (const auto& stage : metrics.stage_latency) {
+        WriteHistogram(oss, "funasr_stage_seconds", "stage=\"" + stage.first + "\"", stage.second);
+    }
+    return oss.str();
+}
+
+MetricsServer::MetricsServer(int port, Renderer renderer) : port_(port), renderer_(std::move(renderer)) {}
+
+MetricsServer::~MetricsServer() {
+    Stop();
+}
+
+bool MetricsServer::Start() {
+    if (running_) return true;
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        Logger::Error("指标服务创建套接字失败: {}", std::strerror(errno));
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd_, 16) < 0) {
+        Logger::Error("指标服务监听端口{}失败: {}", port_, std::strerror(errno));
+        Stop();
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0) {
+        Logger::Error("指标服务创建epoll失败: {}", std::strerror(errno));
+        Stop();
+        return false;
+    }
+    SetListening(true);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::Run, this);
+    Logger::Info("📡 指标服务已启动: http://127.0.0.1:{}/metrics", port_);
+    return true;
+}
+
+void MetricsServer::Stop() {
+    if (running_.exchange(false) && wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(wake_fd_, &one, sizeof(one));
+        (void)written;
+    }
+    if (thread_.joinable()) thread_.join();
+    for (const auto& connection : connections_) close(connection.first);
+    connections_.clear();
+    listening_ = false;
+    for (int* fd : {&listen_fd_, &epoll_fd_, &wake_fd_, &spare_fd_}) {
+        if (*fd >= 0) close(*fd);
+        *fd = -1;
+    }
+}
+
+void MetricsServer::Run() {
+    epoll_event events[32];
+    while (running_) {
+        // 有限超时: 即使没有事件也定期清理超时连接、恢复暂停的监听
+        int ready = epoll_wait(epoll_fd_, events, 32, kSweepIntervalMs);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            Logger::Error("指标服务epoll_wait失败: {}", std::strerror(errno));
+            break;
+        }
+        for (int i = 0; i < ready && running_; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == wake_fd_) continue;
+            if (fd == listen_fd_) {
+                Accept();
+            } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                Close(fd);
+            } else if (events[i].events & EPOLLIN) {
+                HandleReadable(fd);
+            } else if (events[i].events & EPOLLOUT) {
+                HandleWritable(fd);
+            }
+        }
+        Sweep();
+    }
+}
+
+void MetricsServer::Sweep() {
+    const auto now = Clock::now();
+    for (auto it = connections_.begin(); it != connections_.end();) {
+        const int fd = it->first;
+        const bool expired = now - it->second.accepted > kConnectionTimeout;
+        ++it;   // Close会从connections_中删除当前连接
+        if (expired) Close(fd);
+    }
+    if (!listening_ && now >= resume_listen_at_) SetListening(true);
+}
+
+void MetricsServer::SetListening(bool listening) {
+    if (listening == listening_) return;
+    if (listening) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = listen_fd_;
+        listening_ = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event) == 0;
+    } else {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, listen_fd_, nullptr);
+        listening_ = false;
+    }
+}
+
+void MetricsServer::Accept() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno == EMFILE || errno == ENFILE) {
+                // 描述符耗尽时监听套接字保持可读，水平触发会让epoll空转:
+                // 先借用预留描述符取出并丢弃一个连接，仍失败则暂停监听一段时间
+                if (spare_fd_ >= 0) {
+                    close(spare_fd_);
+                    int dropped = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+                    const int accept_errno = errno;
+                    if (dropped >= 0) close(dropped);
+                    spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                    if (dropped >= 0 && spare_fd_ >= 0) continue;
+                    if (dropped < 0 && (accept_errno == EAGAIN || accept_errno == EWOULDBLOCK)) return;
+                }
+                Logger::Warn("指标服务文件描述符耗尽 ({})，暂停接受连接{}ms", std::strerror(errno), kAcceptBackoffMs);
+                SetListening(false);
+                resume_listen_at_ = Clock::now() + std::chrono::milliseconds(kAcceptBackoffMs);
+            }
+            return;   // EAGAIN: 已取完
+        }
+        if (connections_.size() >= kMaxConnections) {
+            close(fd);
+            continue;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+        connections_[fd].accepted = Clock::now();
+    }
+}
+
+void MetricsServer::HandleReadable(int fd) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;
+    Connection& connection = it->second;
+    char buffer[2048];
+    while (true) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            connection.request.append(buffer, static_cast<size_t>(n));
+            if (connection.request.size() > kMaxRequestBytes) {
+                Close(fd);
+                return;
+            }
+            continue;
+        }
+        if (n == 0) {
+            // 客户端发完请求后半关闭写端仍需应答；请求头未完整即关闭的连接直接丢弃
+            if (connection.request.find("\r\n\r\n") != std::string::npos) break;
+            Close(fd);
+            return;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        if (errno == EINTR) continue;
+        Close(fd);
+        return;
+    }
+    if (connection.request.find("\r\n\r\n") == std::string::npos) return;   // 等待请求头读完
+
+    connection.response = BuildResponse(connection.request);
+    epoll_event event{};
+    event.events = EPOLLOUT;
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
+    HandleWritable(fd);
+}
+
+void MetricsServer::HandleWritable(int fd) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;
+    Connection& connection = it->second;
+    while (connection.sent < connection.response.size()) {
+        ssize_t n = send(fd, connection.response.data() + connection.sent,
+                         connection.response.size() - connection.sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            connection.sent += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;   // 等待EPOLLOUT
+        } else {
+            break;
+        }
+    }
+    Close(fd);
+}
+
+void MetricsServer::Close(int fd) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections_.erase(fd);
+}
+
+std::string MetricsServer::BuildResponse(const std::string& request) const {
+    const size_t line_end = request.find("\r\n");
+    const std::string request_line = request.substr(0, line_end);
+    std::string status = "200 OK";
+    std::string content_type = "text/plain; version=0.0.4; charset=utf-8";
+    std::string body;
+    if (request_line.rfind("GET /metrics ", 0) == 0 || request_line.rfind("GET /metrics?", 0) == 0) {
+        body = renderer_();
+    } else if (request_line.rfind("GET ", 0) == 0) {
+        status = "404 Not Found";
+        content_type = "text/plain; charset=utf-8";
+        body = "not found, try /metrics\n";
+    } else {
+        status = "405 Method Not Allowed";
+        content_type = "text/plain; charset=utf-8";
+        body = "method not allowed\n";
+    }
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: " << content_type << "\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    return response.str();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "utils.h"
+
+/**
+ * 把性能指标渲染为Prometheus文本格式 (text/plain; version=0.0.4)
+ *
+ * - 计数器: 请求数、成功数、已处理音频秒数
+ * - 仪表: 最近一次RTF/延迟、滑动窗口吞吐/RTF/错误率/空结果数、流水线队列、内存
+ * - 直方图: 各模式与各识别阶段的延迟 (秒)，细分桶按上界归入固定的le边界
+ */
+std::string FormatPrometheusMetrics(const PerformanceMetrics& metrics);
+
+/**
+ * 指标HTTP服务 - 单线程epoll，在本机端口上提供 GET /metrics
+ *
+ * 🆕 之前只能等测试结束看报告文件或看10秒一次的进度日志:
+ * - 只监听127.0.0.1，不依赖外部服务；非阻塞套接字 + epoll，一个线程处理所有连接
+ * - 每次抓取在服务线程内调用renderer生成文本，renderer应只读取无锁快照，
+ *   抓取不会阻塞识别线程
+ * - 每个连接处理一个请求后关闭 (Connection: close)，其他路径返回404
+ * - 连接超过kConnectionTimeout未完成即关闭，空闲连接不会长期占满连接上限；
+ *   描述符耗尽时丢弃新连接或暂停监听，避免epoll空转
+ */
+class MetricsServer {
+public:
+    using Renderer = std::function<std::string()>;
+
+    MetricsServer(int port, Renderer renderer);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * 绑定端口并启动服务线程，失败返回false
+     */
+    bool Start();
+    void Stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        Clock::time_point accepted;
+        std::string request;
+        std::string response;
+        size_t sent = 0;
+    };
+
+    void Run();
+    void Accept();
+    void HandleReadable(int fd);
+    void HandleWritable(int fd);
+    void Close(int fd);
+    void Sweep();                        // 关闭超时连接，到期后恢复监听
+    void SetListening(bool listening);
+    std::string BuildResponse(const std::string& request) const;
+
+    static constexpr size_t kMaxRequestBytes = 8192;
+    static constexpr size_t kMaxConnections = 64;
+    static constexpr std::chrono::seconds kConnectionTimeout{5};
+    static constexpr int kSweepIntervalMs = 1000;
+    static constexpr int kAcceptBackoffMs = 1000;
+
+    int port_;
+    Renderer renderer_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;                                  // eventfd，Stop时唤醒epoll_wait
+    int spare_fd_ = -1;                                 // 预留描述符，耗尽时用于取出并丢弃连接
+    bool listening_ = false;                            // 监听套接字是否在epoll中
+    Clock::time_point resume_listen_at_;                // 暂停监听后的恢复时间
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::unordered_map<int, Connection> connections_;   // 仅服务线程访问
+};
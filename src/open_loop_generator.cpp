@@ -0,0 +1,162 @@
+#include "open_loop_generator.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+OpenLoopGenerator::OpenLoopGenerator(int num_workers) : num_workers_(std::max(1, num_workers)) {}
+
+std::vector<double> OpenLoopGenerator::PoissonArrivals(double rate_per_second, size_t count, uint32_t seed) {
+    std::vector<double> arrivals;
+    if (rate_per_second <= 0) return arrivals;
+    arrivals.reserve(count);
+    std::mt19937 gen(seed);
+    std::exponential_distribution<double> interval(rate_per_second);
+    double t = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        arrivals.push_back(t);
+        t += interval(gen);
+    }
+    return arrivals;
+}
+
+bool OpenLoopGenerator::LoadTrace(const std::string& path, std::vector<double>& arrivals) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        Logger::Error("无法打开到达轨迹文件: {}", path);
+        return false;
+    }
+    arrivals.clear();
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') continue;
+        try {
+            arrivals.push_back(std::stod(line.substr(begin)));
+        } catch (const std::exception&) {
+            Logger::Error("到达轨迹第{}行无法解析: {}", line_number, line);
+            return false;
+        }
+    }
+    if (arrivals.empty()) {
+        Logger::Error("到达轨迹为空: {}", path);
+        return false;
+    }
+    std::sort(arrivals.begin(), arrivals.end());
+    const double first = arrivals.front();
+    for (double& t : arrivals) t -= first;
+    return true;
+}
+
+double OpenLoopGenerator::OfferedRate(const std::vector<double>& arrivals) {
+    if (arrivals.size() < 2 || arrivals.back() <= 0) return 0.0;
+    // n个到达跨越n-1个间隔
+    return (arrivals.size() - 1) / arrivals.back();
+}
+
+std::vector<double> OpenLoopGenerator::ScaleToRate(const std::vector<double>& arrivals, double rate_per_second) {
+    double current = OfferedRate(arrivals);
+    if (current <= 0 || rate_per_second <= 0) return arrivals;
+    const double factor = current / rate_per_second;
+    std::vector<double> scaled;
+    scaled.reserve(arrivals.size());
+    for (double t : arrivals) scaled.push_back(t * factor);
+    return scaled;
+}
+
+OpenLoopGenerator::Report OpenLoopGenerator::Run(const std::vector<double>& arrivals, const Request& request) const {
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    struct Slot {
+        Clock::time_point arrival;
+        Clock::time_point start;
+        Clock::time_point finish;
+        double audio_seconds = -1.0;
+    };
+    std::vector<Slot> slots(arrivals.size());
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> pending;
+    bool dispatch_done = false;
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers_);
+    for (int w = 0; w < num_workers_; ++w) {
+        workers.emplace_back([&]() {
+            while (true) {
+                size_t index;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&]() { return !pending.empty() || dispatch_done; });
+                    if (pending.empty()) return;
+                    index = pending.front();
+                    pending.pop_front();
+                }
+                Slot& slot = slots[index];
+                slot.start = Clock::now();
+                try {
+                    slot.audio_seconds = request(index);
+                } catch (const std::exception& e) {
+                    Logger::Error("开环请求#{}异常: {}", index, e.what());
+                    slot.audio_seconds = -1.0;
+                }
+                slot.finish = Clock::now();
+            }
+        });
+    }
+
+    // 调度线程只按时刻投放，不等待处理结果 (开环)
+    const auto base = Clock::now();
+    for (size_t i = 0; i < arrivals.size(); ++i) {
+        auto arrival = base + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(arrivals[i]));
+        std::this_thread::sleep_until(arrival);
+        slots[i].arrival = arrival;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(i);
+        }
+        cv.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dispatch_done = true;
+    }
+    cv.notify_all();
+    for (auto& worker : workers) worker.join();
+
+    Report report;
+    report.offered_rps = OfferedRate(arrivals);
+    report.submitted = arrivals.size();
+    std::vector<double> queue_wait, service, latency;
+    Clock::time_point last_finish = base;
+    double audio_seconds = 0.0;
+    for (const auto& slot : slots) {
+        last_finish = std::max(last_finish, slot.finish);
+        if (slot.audio_seconds < 0) {
+            report.failed++;
+            continue;
+        }
+        report.completed++;
+        audio_seconds += slot.audio_seconds;
+        queue_wait.push_back(Ms(slot.start - slot.arrival).count());
+        service.push_back(Ms(slot.finish - slot.start).count());
+        latency.push_back(Ms(slot.finish - slot.arrival).count());
+    }
+    report.wall_seconds = Ms(last_finish - base).count() / 1000.0;
+    if (report.wall_seconds > 0) {
+        report.achieved_rps = report.completed / report.wall_seconds;
+        report.audio_speed = audio_seconds / report.wall_seconds;
+    }
+    report.queue_wait = LatencySummary::FromSamples(std::move(queue_wait));
+    report.service = LatencySummary::FromSamples(std::move(service));
+    report.latency = LatencySummary::FromSamples(std::move(latency));
+    return report;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+/**
+ * 开环负载发生器 - 按到达时刻提交请求，与处理速度无关
+ *
+ * 🆕 闭环测试 (一个完成再发下一个) 永远不会排队，看不到过载时的延迟膨胀:
+ * - 到达时刻由泊松过程生成，或从线上抓取的到达轨迹读入 (可按目标速率整体缩放)
+ * - 调度线程按到达时刻把请求放入先进先出队列，固定数量的工作线程依次取出处理
+ * - 每个请求记录排队等待 (到达→开始)、服务时间 (开始→完成) 与总延迟 (到达→完成)
+ *
+ * 提供的负载超过处理能力时队列会持续增长，请求数应按可接受的测试时长设定。
+ */
+class OpenLoopGenerator {
+public:
+    /**
+     * 处理第index个请求，返回处理的音频时长 (秒)，失败返回负数
+     * (在工作线程中调用)
+     */
+    using Request = std::function<double(size_t index)>;
+
+    struct Report {
+        double offered_rps = 0.0;        // 提供的到达速率 (请求/秒)
+        double achieved_rps = 0.0;       // 完成速率 (完成数 / 首个到达到最后完成)
+        double audio_speed = 0.0;        // 每秒处理的音频秒数
+        size_t submitted = 0;
+        size_t completed = 0;
+        size_t failed = 0;
+        double wall_seconds = 0.0;
+        LatencySummary queue_wait;
+        LatencySummary service;
+        LatencySummary latency;
+    };
+
+    explicit OpenLoopGenerator(int num_workers);
+
+    /**
+     * 泊松到达 - 指数分布间隔，返回count个相对到达时刻 (秒，升序)
+     */
+    static std::vector<double> PoissonArrivals(double rate_per_second, size_t count, uint32_t seed);
+
+    /**
+     * 读取到达轨迹 - 每行一个到达时刻 (秒)，忽略空行与#注释，结果平移到从0开始并排序
+     */
+    static bool LoadTrace(const std::string& path, std::vector<double>& arrivals);
+
+    /**
+     * 到达序列的平均速率 (请求/秒)
+     */
+    static double OfferedRate(const std::vector<double>& arrivals);
+
+    /**
+     * 按时间整体缩放到达序列，使平均速率为rate_per_second (保持突发形态)
+     */
+    static std::vector<double> ScaleToRate(const std::vector<double>& arrivals, double rate_per_second);
+
+    /**
+     * 按到达序列运行一轮，阻塞到所有请求完成
+     */
+    Report Run(const std::vector<double>& arrivals, const Request& request) const;
+
+    int NumWorkers() const { return num_workers_; }
+
+private:
+    int num_workers_;
+};
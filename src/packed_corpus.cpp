@@ -0,0 +1,263 @@
+#include "packed_corpus.h"
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[8] = {'F', 'A', 'C', 'O', 'R', 'P', 'U', 'S'};
+const uint32_t kVersion = 1;
+const uint64_t kDataAlignment = 4096;
+
+struct CorpusHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t sample_rate;
+    uint64_t entry_count;
+    uint64_t data_offset;
+    uint64_t data_size;       // 字节
+    uint64_t index_offset;
+    uint64_t index_size;      // 字节
+    uint64_t reserved;
+};
+static_assert(sizeof(CorpusHeader) == 64, "CorpusHeader must be 64 bytes");
+
+/**
+ * 读取与 WAV 同名的参考文本 (.txt 或 .lab)
+ */
+std::string ReadReferenceText(const std::string& wav_path) {
+    for (const char* ext : {".txt", ".lab"}) {
+        std::filesystem::path text_path(wav_path);
+        text_path.replace_extension(ext);
+        std::ifstream text_file(text_path);
+        if (text_file.is_open()) {
+            std::string text((std::istreambuf_iterator<char>(text_file)), std::istreambuf_iterator<char>());
+            while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.pop_back();
+            return text;
+        }
+    }
+    return "";
+}
+
+template <typename T>
+void WritePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void WriteString(std::ofstream& out, const std::string& text) {
+    WritePod(out, static_cast<uint32_t>(text.size()));
+    out.write(text.data(), text.size());
+}
+
+}  // namespace
+
+PackedCorpus::~PackedCorpus() {
+    Close();
+}
+
+int PackedCorpus::Build(const std::vector<std::string>& wav_files, const std::string& output_path) {
+    std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        Logger::Error("无法创建打包语料文件: {}", output_path);
+        return -1;
+    }
+    
+    CorpusHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.sample_rate = kSampleRate;
+    header.data_offset = kDataAlignment;
+    WritePod(out, header);
+    out.seekp(header.data_offset);
+    
+    std::vector<Entry> entries;
+    std::vector<int16_t> pcm;
+    uint64_t sample_offset = 0;
+    Timer build_timer;
+    
+    for (size_t i = 0; i < wav_files.size(); ++i) {
+        auto audio = AudioFileReader::ReadWavFile(wav_files[i]);
+        if (!audio.IsValid()) {
+            Logger::Warn("跳过无效音频文件: {}", wav_files[i]);
+            continue;
+        }
+        if (audio.sample_rate != kSampleRate) {
+            audio.samples = AudioFileReader::Resample(audio.samples, audio.sample_rate, kSampleRate);
+        }
+        
+        pcm.resize(audio.samples.size());
+        for (size_t j = 0; j < audio.samples.size(); ++j) {
+            float value = std::max(-1.0f, std::min(1.0f, audio.samples[j]));
+            pcm[j] = static_cast<int16_t>(std::lround(value * 32767.0f));
+        }
+        out.write(reinterpret_cast<const char*>(pcm.data()), pcm.size() * sizeof(int16_t));
+        
+        Entry entry;
+        entry.id = std::filesystem::path(wav_files[i]).filename().string();
+        entry.offset = sample_offset;
+        entry.length = pcm.size();
+        entry.duration_seconds = static_cast<double>(pcm.size()) / kSampleRate;
+        entry.reference_text = ReadReferenceText(wav_files[i]);
+        entries.push_back(std::move(entry));
+        sample_offset += pcm.size();
+    }
+    
+    header.entry_count = entries.size();
+    header.data_size = sample_offset * sizeof(int16_t);
+    header.index_offset = header.data_offset + header.data_size;
+    out.seekp(header.index_offset);
+    for (const auto& entry : entries) {
+        WritePod(out, entry.offset);
+        WritePod(out, entry.length);
+        WritePod(out, entry.duration_seconds);
+        WriteString(out, entry.id);
+        WriteString(out, entry.reference_text);
+    }
+    header.index_size = static_cast<uint64_t>(out.tellp()) - header.index_offset;
+    out.seekp(0);
+    WritePod(out, header);
+    out.close();
+    
+    if (!out) {
+        Logger::Error("写入打包语料失败: {}", output_path);
+        return -1;
+    }
+    
+    std::ostringstream build_log;
+    build_log << "打包语料完成: " << output_path << ", " << entries.size() << "/" << wav_files.size()
+              << "个文件, " << std::fixed << std::setprecision(2) << sample_offset / double(kSampleRate) / 3600.0
+              << "小时, 耗时: " << std::setprecision(1) << build_timer.ElapsedMs() / 1000.0 << "秒";
+    Logger::Info(build_log.str());
+    return static_cast<int>(entries.size());
+}
+
+bool PackedCorpus::Open(const std::string& path) {
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        Logger::Error("无法打开打包语料: {}", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CorpusHeader)) {
+        Logger::Error("打包语料文件无效: {}", path);
+        close(fd);
+        return false;
+    }
+    mapped_size_ = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        Logger::Error("mmap打包语料失败: {}", path);
+        mapped_size_ = 0;
+        return false;
+    }
+    mapped_ = mapped;
+    // 基准测试与批处理按顺序访问
+    madvise(mapped_, mapped_size_, MADV_SEQUENTIAL);
+    
+    const char* base = static_cast<const char*>(mapped_);
+    CorpusHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.sample_rate != kSampleRate ||
+        header.index_offset + header.index_size > mapped_size_ ||
+        header.data_offset + header.data_size > mapped_size_) {
+        Logger::Error("打包语料格式不匹配: {}", path);
+        Close();
+        return false;
+    }
+    data_ = reinterpret_cast<const int16_t*>(base + header.data_offset);
+    
+    // 解析索引
+    const char* cursor = base + header.index_offset;
+    const char* index_end = cursor + header.index_size;
+    auto read_bytes = [&cursor, index_end](void* dst, size_t size) {
+        if (cursor + size > index_end) return false;
+        std::memcpy(dst, cursor, size);
+        cursor += size;
+        return true;
+    };
+    auto read_string = [&read_bytes, &cursor, index_end](std::string& text) {
+        uint32_t length = 0;
+        if (!read_bytes(&length, sizeof(length)) || cursor + length > index_end) return false;
+        text.assign(cursor, length);
+        cursor += length;
+        return true;
+    };
+    
+    const uint64_t total_samples = header.data_size / sizeof(int16_t);
+    entries_.reserve(header.entry_count);
+    for (uint64_t i = 0; i < header.entry_count; ++i) {
+        Entry entry;
+        if (!read_bytes(&entry.offset, sizeof(entry.offset)) ||
+            !read_bytes(&entry.length, sizeof(entry.length)) ||
+            !read_bytes(&entry.duration_seconds, sizeof(entry.duration_seconds)) ||
+            !read_string(entry.id) || !read_string(entry.reference_text) ||
+            entry.offset + entry.length > total_samples) {
+            Logger::Error("打包语料索引损坏: {} (条目{})", path, i);
+            Close();
+            return false;
+        }
+        entries_.push_back(std::move(entry));
+    }
+    
+    std::ostringstream open_log;
+    open_log << "打包语料已加载: " << path << ", " << entries_.size() << "个条目, "
+             << std::fixed << std::setprecision(1) << mapped_size_ / (1024.0 * 1024.0) << "MB";
+    Logger::Info(open_log.str());
+    return true;
+}
+
+void PackedCorpus::Close() {
+    if (mapped_) {
+        munmap(mapped_, mapped_size_);
+    }
+    mapped_ = nullptr;
+    mapped_size_ = 0;
+    data_ = nullptr;
+    entries_.clear();
+}
+
+const int16_t* PackedCorpus::Samples(size_t index) const {
+    return data_ + entries_[index].offset;
+}
+
+AudioFileReader::AudioData PackedCorpus::ToAudioData(size_t index) const {
+    AudioFileReader::AudioData audio;
+    const Entry& entry = entries_[index];
+    const int16_t* samples = Samples(index);
+    audio.samples.resize(entry.length);
+    for (uint64_t i = 0; i < entry.length; ++i) {
+        audio.samples[i] = static_cast<float>(samples[i]) / 32768.0f;
+    }
+    audio.sample_rate = kSampleRate;
+    audio.channels = 1;
+    audio.duration_seconds = entry.duration_seconds;
+    return audio;
+}
+
+std::pair<size_t, size_t> PackedCorpus::ShardRange(int shard, int num_shards) const {
+    if (num_shards <= 1 || entries_.empty()) {
+        return {0, entries_.size()};
+    }
+    double total = 0.0;
+    for (const auto& entry : entries_) total += entry.duration_seconds;
+    
+    // 分片边界取累计时长首次达到 k/num_shards 的位置
+    auto boundary = [this, total, num_shards](int k) -> size_t {
+        if (k <= 0) return 0;
+        if (k >= num_shards) return entries_.size();
+        double target = total * k / num_shards;
+        double accumulated = 0.0;
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (accumulated >= target) return i;
+            accumulated += entries_[i].duration_seconds;
+        }
+        return entries_.size();
+    };
+    return {boundary(shard), boundary(shard + 1)};
+}
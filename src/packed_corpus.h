@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utils.h"
+
+/**
+ * 打包语料格式 - 单文件 mmap 读取
+ * 
+ * 🆕 把目录中的大量 WAV 预先转换为一个连续的 16kHz int16 数据块加索引，
+ * 基准测试和批处理任务启动时无需逐个打开/解析/转换文件，按顺序 I/O 读取，
+ * 并可按索引区间把语料分片给多个进程或工作线程。
+ * 
+ * 文件布局 (小端):
+ * ┌──────────────┬──────────────────────────┬──────────────┐
+ * │ Header 64字节 │ 音频数据 (4KB对齐, int16) │ 索引          │
+ * └──────────────┴──────────────────────────┴──────────────┘
+ * 索引条目: offset(u64, 样本) length(u64, 样本) duration(f64)
+ *           id_len(u32) id  text_len(u32) text
+ */
+class PackedCorpus {
+public:
+    struct Entry {
+        std::string id;               // 条目标识 (原始文件名)
+        uint64_t offset = 0;          // 数据区内的样本偏移
+        uint64_t length = 0;          // 样本数
+        double duration_seconds = 0.0;
+        std::string reference_text;   // 参考文本 (可选，来自同名 .txt/.lab)
+    };
+    
+    static constexpr int kSampleRate = 16000;
+    
+    PackedCorpus() = default;
+    ~PackedCorpus();
+    PackedCorpus(const PackedCorpus&) = delete;
+    PackedCorpus& operator=(const PackedCorpus&) = delete;
+    
+    /**
+     * 打包 WAV 文件列表 - 逐个解码、重采样到16kHz并转为 int16 写入
+     * @return 成功写入的条目数，失败返回-1
+     */
+    static int Build(const std::vector<std::string>& wav_files, const std::string& output_path);
+    
+    /**
+     * 以只读 mmap 打开打包语料并解析索引
+     */
+    bool Open(const std::string& path);
+    void Close();
+    
+    bool IsOpen() const { return mapped_ != nullptr; }
+    size_t Size() const { return entries_.size(); }
+    const Entry& GetEntry(size_t index) const { return entries_[index]; }
+    const std::vector<Entry>& Entries() const { return entries_; }
+    
+    /**
+     * 条目的 int16 样本指针 (直接指向 mmap 区域，零拷贝)
+     */
+    const int16_t* Samples(size_t index) const;
+    
+    /**
+     * 转换为引擎使用的归一化 float 音频
+     */
+    AudioFileReader::AudioData ToAudioData(size_t index) const;
+    
+    /**
+     * 第 shard 个分片的条目区间 [begin, end)，按总时长均衡切分
+     */
+    std::pair<size_t, size_t> ShardRange(int shard, int num_shards) const;
+
+private:
+    void* mapped_ = nullptr;
+    size_t mapped_size_ = 0;
+    const int16_t* data_ = nullptr;
+    std::vector<Entry> entries_;
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * 流水线阶段 - 独立工作线程 + 有界队列 + 按批处理
+ * 
+ * 🆕 VAD → ASR → 标点 各阶段互相重叠执行:
+ * - Push在队列满时阻塞，下游变慢时背压逐级传回提交方
+ * - 工作线程每次最多取max_batch个请求交给处理函数 (批量推理的切入点)
+ * - 统计按时间加权的平均队列占用与峰值，用于定位瓶颈阶段；
+ *   统计值在持锁修改时发布到原子变量，GetStats不加锁 (指标抓取不与Push/工作线程争锁)
+ */
+template <typename Item>
+class PipelineStage {
+public:
+    using BatchHandler = std::function<void(std::vector<Item>& batch)>;
+    
+    struct Stats {
+        uint64_t processed = 0;          // 已处理请求数
+        uint64_t batches = 0;            // 处理批次数
+        size_t queued = 0;               // 当前排队数
+        size_t peak_queued = 0;          // 峰值排队数
+        double avg_queued = 0.0;         // 时间加权平均排队数
+        
+        double AvgBatch() const { return batches > 0 ? double(processed) / batches : 0.0; }
+    };
+    
+    PipelineStage(std::string name, int num_workers, size_t capacity, size_t max_batch, BatchHandler handler)
+        : name_(std::move(name)),
+          capacity_(std::max<size_t>(1, capacity)),
+          max_batch_(std::max<size_t>(1, max_batch)),
+          handler_(std::move(handler)),
+          start_time_(Clock::now()),
+          last_change_(start_time_.time_since_epoch().count()) {
+        num_workers = std::max(1, num_workers);
+        for (int i = 0; i < num_workers; ++i) {
+            workers_.emplace_back(&PipelineStage::WorkerLoop, this);
+        }
+    }
+    
+    // 处理完已排队的请求后停止
+    ~PipelineStage() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+    
+    PipelineStage(const PipelineStage&) = delete;
+    PipelineStage& operator=(const PipelineStage&) = delete;
+    
+    /**
+     * 提交请求 (队列满时阻塞)
+     */
+    void Push(Item item) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_full_.wait(lock, [this]() { return stopping_ || queue_.size() < capacity_; });
+            if (stopping_) {
+                // 阶段已停止: 在调用线程处理，保证请求不会丢失
+                lock.unlock();
+                std::vector<Item> batch;
+                batch.push_back(std::move(item));
+                handler_(batch);
+                return;
+            }
+            AccumulateOccupancy();
+            queue_.push_back(std::move(item));
+            queued_.store(queue_.size(), std::memory_order_relaxed);
+            if (queue_.size() > peak_queued_.load(std::memory_order_relaxed)) {
+                peak_queued_.store(queue_.size(), std::memory_order_relaxed);
+            }
+        }
+        not_empty_.notify_one();
+    }
+    
+    // 不加锁: 各字段分别原子读取，与并发的队列变化最多相差一次更新
+    Stats GetStats() const {
+        Stats stats;
+        stats.processed = processed_.load(std::memory_order_relaxed);
+        stats.batches = batches_.load(std::memory_order_relaxed);
+        stats.queued = queued_.load(std::memory_order_relaxed);
+        stats.peak_queued = peak_queued_.load(std::memory_order_relaxed);
+        auto now = Clock::now();
+        auto last_change = Clock::time_point(Clock::duration(last_change_.load(std::memory_order_acquire)));
+        double elapsed = std::chrono::duration<double>(now - start_time_).count();
+        double pending = std::max(0.0, std::chrono::duration<double>(now - last_change).count());
+        double area = occupancy_area_.load(std::memory_order_relaxed) + stats.queued * pending;
+        stats.avg_queued = elapsed > 0.0 ? area / elapsed : 0.0;
+        return stats;
+    }
+    
+    const std::string& Name() const { return name_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    // 调用方持有mutex_，在队列长度变化前累计占用面积 (写入只发生在持锁时，原子变量仅供GetStats读取)
+    void AccumulateOccupancy() {
+        auto now = Clock::now();
+        auto last_change = Clock::time_point(Clock::duration(last_change_.load(std::memory_order_relaxed)));
+        occupancy_area_.store(occupancy_area_.load(std::memory_order_relaxed) +
+                                  queue_.size() * std::chrono::duration<double>(now - last_change).count(),
+                              std::memory_order_relaxed);
+        last_change_.store(now.time_since_epoch().count(), std::memory_order_release);
+    }
+    
+    void WorkerLoop() {
+        std::vector<Item> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_empty_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) return;
+                AccumulateOccupancy();
+                size_t count = std::min(max_batch_, queue_.size());
+                batch.clear();
+                for (size_t i = 0; i < count; ++i) {
+                    batch.push_back(std::move(queue_.front()));
+                    queue_.pop_front();
+                }
+                queued_.store(queue_.size(), std::memory_order_relaxed);
+                processed_.fetch_add(count, std::memory_order_relaxed);
+                batches_.fetch_add(1, std::memory_order_relaxed);
+            }
+            not_full_.notify_all();
+            handler_(batch);
+        }
+    }
+    
+    const std::string name_;
+    const size_t capacity_;
+    const size_t max_batch_;
+    BatchHandler handler_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<Item> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+    
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> peak_queued_{0};
+    Clock::time_point start_time_;
+    std::atomic<Clock::rep> last_change_;
+    std::atomic<double> occupancy_area_{0.0};
+};
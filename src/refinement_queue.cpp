@@ -0,0 +1,203 @@
+#include "refinement_queue.h"
+#include "utils.h"
+#include <algorithm>
+
+// ============ RefinementSink ============
+
+void RefinementSink::SetCallback(Callback callback) {
+    std::lock_guard<std::mutex> callback_lock(callback_mutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = std::move(callback);
+}
+
+uint64_t RefinementSink::BeginSegment() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight_++;
+    return next_assign_++;
+}
+
+void RefinementSink::Deliver(RefinedSegment segment) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    reorder_[segment.segment_index] = std::move(segment);
+    // 已有线程在投递时由它顺带投递本段，保证回调按序号串行执行
+    if (delivering_) return;
+    delivering_ = true;
+    
+    while (true) {
+        auto it = reorder_.find(next_deliver_);
+        if (it == reorder_.end()) break;
+        RefinedSegment ready = std::move(it->second);
+        reorder_.erase(it);
+        next_deliver_++;
+        
+        if (callback_) {
+            lock.unlock();
+            {
+                // 回调写入同时持有两把锁，持有callback_mutex_即可安全读取
+                std::lock_guard<std::mutex> callback_lock(callback_mutex_);
+                if (callback_) {
+                    callback_(ready);
+                } else {
+                    // 投递途中回调被解除，结果退回完成队列
+                    std::lock_guard<std::mutex> relock(mutex_);
+                    completed_.push_back(std::move(ready));
+                }
+            }
+            lock.lock();
+        } else {
+            completed_.push_back(std::move(ready));
+        }
+        in_flight_--;
+    }
+    
+    delivering_ = false;
+    if (in_flight_ == 0) idle_cv_.notify_all();
+}
+
+std::vector<RefinedSegment> RefinementSink::TakeCompleted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<RefinedSegment> completed;
+    completed.swap(completed_);
+    return completed;
+}
+
+void RefinementSink::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return in_flight_ == 0; });
+}
+
+size_t RefinementSink::InFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+}
+
+// ============ RefinementQueue ============
+
+RefinementQueue::RefinementQueue(TaskExecutor& executor, int max_parallel, size_t capacity, Processor processor)
+    : executor_(executor),
+      max_parallel_(std::max(1, max_parallel)),
+      capacity_(std::max<size_t>(1, capacity)),
+      processor_(std::move(processor)) {}
+
+RefinementQueue::~RefinementQueue() {
+    std::vector<std::shared_ptr<Job>> abandoned;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stopping_ = true;
+        while (!jobs_.empty()) {
+            abandoned.push_back(jobs_.top());
+            jobs_.pop();
+        }
+        queued_.store(0, std::memory_order_relaxed);
+        idle_cv_.wait(lock, [this]() { return active_ == 0; });
+    }
+    // 未开始的语音段以dropped状态投递，等待中的会话不会卡住
+    for (auto& job : abandoned) {
+        RefinedSegment segment;
+        segment.segment_index = job->segment_index;
+        segment.audio_ms = job->audio.size / 16.0;
+        segment.dropped = true;
+        job->sink->Deliver(std::move(segment));
+    }
+}
+
+bool RefinementQueue::Submit(const std::shared_ptr<RefinementSink>& sink, AudioView audio) {
+    auto job = std::make_shared<Job>();
+    job->sink = sink;
+    job->segment_index = sink->BeginSegment();
+    job->enqueue_time = Clock::now();
+    // 截止时间 = 入队时间 + 语音段时长: 短段先完成，长段随等待时间前移
+    job->deadline = job->enqueue_time + std::chrono::microseconds(static_cast<int64_t>(audio.size * 1000 / 16));
+    job->audio = std::move(audio);
+    
+    bool start_pump = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopping_ && jobs_.size() < capacity_) {
+            jobs_.push(job);
+            queued_.store(jobs_.size(), std::memory_order_relaxed);
+            if (active_ < max_parallel_) {
+                active_++;
+                active_count_.store(active_, std::memory_order_relaxed);
+                start_pump = true;
+            }
+            job.reset();
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    if (job) {
+        Logger::Warn("离线精化队列已满 ({}段)，语音段#{}未精化", capacity_, job->segment_index);
+        RefinedSegment segment;
+        segment.segment_index = job->segment_index;
+        segment.audio_ms = job->audio.size / 16.0;
+        segment.dropped = true;
+        job->sink->Deliver(std::move(segment));
+        return false;
+    }
+    if (start_pump) {
+        executor_.Post(TaskExecutor::TaskClass::kThroughput, [this]() { Pump(); });
+    }
+    return true;
+}
+
+void RefinementQueue::Pump() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (jobs_.empty()) {
+                active_--;
+                active_count_.store(active_, std::memory_order_relaxed);
+                if (active_ == 0) idle_cv_.notify_all();
+                return;
+            }
+            job = jobs_.top();
+            jobs_.pop();
+            queued_.store(jobs_.size(), std::memory_order_relaxed);
+        }
+        
+        RefinedSegment segment;
+        segment.segment_index = job->segment_index;
+        segment.audio_ms = job->audio.size / 16.0;
+        auto start = Clock::now();
+        segment.queue_wait_ms = std::chrono::duration<double, std::milli>(start - job->enqueue_time).count();
+        try {
+            segment.text = processor_(job->audio.data, job->audio.size);
+        } catch (const std::exception& e) {
+            Logger::Error("离线精化异常: {}", e.what());
+        }
+        segment.refine_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        RecordCompletion(segment.queue_wait_ms, segment.LatencyMs());
+        
+        job->audio = AudioView();  // 释放视图，会话环形缓冲可继续覆盖该区间
+        job->sink->Deliver(std::move(segment));
+    }
+}
+
+void RefinementQueue::RecordCompletion(double wait_ms, double latency_ms) {
+    // 写入方之间仍由mutex_串行，原子变量只为GetStats无锁读取
+    std::lock_guard<std::mutex> lock(mutex_);
+    total_wait_ms_.store(total_wait_ms_.load(std::memory_order_relaxed) + wait_ms, std::memory_order_relaxed);
+    max_wait_ms_.store(std::max(max_wait_ms_.load(std::memory_order_relaxed), wait_ms), std::memory_order_relaxed);
+    total_latency_ms_.store(total_latency_ms_.load(std::memory_order_relaxed) + latency_ms, std::memory_order_relaxed);
+    max_latency_ms_.store(std::max(max_latency_ms_.load(std::memory_order_relaxed), latency_ms),
+                          std::memory_order_relaxed);
+    completed_.fetch_add(1, std::memory_order_release);
+}
+
+RefinementQueue::Stats RefinementQueue::GetStats() const {
+    Stats stats;
+    stats.completed = completed_.load(std::memory_order_acquire);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.queued = queued_.load(std::memory_order_relaxed);
+    stats.active = active_count_.load(std::memory_order_relaxed);
+    stats.max_wait_ms = max_wait_ms_.load(std::memory_order_relaxed);
+    stats.max_latency_ms = max_latency_ms_.load(std::memory_order_relaxed);
+    if (stats.completed > 0) {
+        stats.avg_wait_ms = total_wait_ms_.load(std::memory_order_relaxed) / stats.completed;
+        stats.avg_latency_ms = total_latency_ms_.load(std::memory_order_relaxed) / stats.completed;
+    }
+    return stats;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+#include "audio_ring_buffer.h"
+#include "task_executor.h"
+
+/**
+ * 离线精化结果 - 一个语音段的最终文本
+ */
+struct RefinedSegment {
+    uint64_t segment_index = 0;          // 会话内语音段序号 (从0开始)
+    std::string text;                    // 离线识别+标点后的文本
+    double audio_ms = 0.0;               // 语音段时长
+    double queue_wait_ms = 0.0;          // 在精化队列中的等待时间
+    double refine_ms = 0.0;              // 离线识别+标点耗时
+    bool dropped = false;                // 队列已满未能精化
+    
+    double LatencyMs() const { return queue_wait_ms + refine_ms; }
+};
+
+/**
+ * 会话级精化结果通道
+ * 
+ * 🆕 精化任务可能乱序完成，通道按语音段序号重排后投递:
+ * 设置了回调则在精化线程中依次回调，否则进入完成队列由会话线程轮询。
+ * 任务持有通道的shared_ptr，会话先销毁也不会悬空。
+ */
+class RefinementSink {
+public:
+    using Callback = std::function<void(const RefinedSegment&)>;
+    
+    /**
+     * 设置结果回调 (传nullptr解除；返回时保证旧回调不再执行)
+     * 回调内不得再调用SetCallback
+     */
+    void SetCallback(Callback callback);
+    
+    /**
+     * 登记一个待精化语音段，返回其序号
+     */
+    uint64_t BeginSegment();
+    
+    /**
+     * 投递精化结果 (由精化工作线程调用)
+     */
+    void Deliver(RefinedSegment segment);
+    
+    /**
+     * 取出完成队列中的结果 (未设置回调时使用)
+     */
+    std::vector<RefinedSegment> TakeCompleted();
+    
+    /**
+     * 等待已登记的语音段全部投递
+     */
+    void WaitIdle();
+    
+    size_t InFlight() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::mutex callback_mutex_;              // 回调执行期间持有，保证解除回调后不再调用
+    std::condition_variable idle_cv_;
+    Callback callback_;
+    std::map<uint64_t, RefinedSegment> reorder_;
+    std::vector<RefinedSegment> completed_;
+    uint64_t next_assign_ = 0;
+    uint64_t next_deliver_ = 0;
+    size_t in_flight_ = 0;
+    bool delivering_ = false;
+};
+
+/**
+ * 2Pass离线精化队列 - 有界优先队列 + 共享执行器上的有限并行度
+ * 
+ * 🆕 语音段按截止时间排序 (入队时间 + 语音段时长)，短段优先但长段不会饿死；
+ * 同时执行的精化任务不超过max_parallel，队列满时语音段以dropped状态立即投递。
+ * 统计值发布在原子变量中，GetStats不加锁 (指标抓取不与提交/精化线程争锁)。
+ */
+class RefinementQueue {
+public:
+    using Processor = std::function<std::string(const float* audio, size_t size)>;
+    
+    struct Stats {
+        uint64_t completed = 0;
+        uint64_t dropped = 0;
+        size_t queued = 0;
+        int active = 0;
+        double avg_wait_ms = 0.0;
+        double max_wait_ms = 0.0;
+        double avg_latency_ms = 0.0;     // 入队到结果投递 (等待+精化)
+        double max_latency_ms = 0.0;
+    };
+    
+    /**
+     * @param executor 执行精化任务的共享执行器 (需比队列存活更久)
+     * @param max_parallel 同时执行的精化任务数
+     * @param capacity 排队语音段上限
+     * @param processor 离线识别+标点，返回最终文本
+     */
+    RefinementQueue(TaskExecutor& executor, int max_parallel, size_t capacity, Processor processor);
+    ~RefinementQueue();
+    
+    RefinementQueue(const RefinementQueue&) = delete;
+    RefinementQueue& operator=(const RefinementQueue&) = delete;
+    
+    /**
+     * 提交16kHz语音段视图 (会话环形缓冲零拷贝)，结果经sink投递
+     * @return 队列已满时返回false，语音段已以dropped状态投递
+     */
+    bool Submit(const std::shared_ptr<RefinementSink>& sink, AudioView audio);
+    
+    Stats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Job {
+        std::shared_ptr<RefinementSink> sink;
+        uint64_t segment_index = 0;
+        AudioView audio;
+        Clock::time_point enqueue_time;
+        Clock::time_point deadline;
+    };
+    
+    struct LaterDeadline {
+        bool operator()(const std::shared_ptr<Job>& a, const std::shared_ptr<Job>& b) const {
+            return a->deadline > b->deadline;
+        }
+    };
+    
+    void Pump();
+    void RecordCompletion(double wait_ms, double latency_ms);
+    
+    TaskExecutor& executor_;
+    const int max_parallel_;
+    const size_t capacity_;
+    Processor processor_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    std::priority_queue<std::shared_ptr<Job>, std::vector<std::shared_ptr<Job>>, LaterDeadline> jobs_;
+    int active_ = 0;
+    bool stopping_ = false;
+    
+    // 统计: 持mutex_写入，GetStats无锁读取
+    std::atomic<size_t> queued_{0};
+    std::atomic<int> active_count_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<double> total_wait_ms_{0.0};
+    std::atomic<double> max_wait_ms_{0.0};
+    std::atomic<double> total_latency_ms_{0.0};
+    std::atomic<double> max_latency_ms_{0.0};
+};
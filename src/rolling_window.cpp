@@ -0,0 +1,106 @@
+#include "rolling_window.h"
+#include <algorithm>
+#include <thread>
+
+constexpr std::array<int, 4> RollingWindow::kWindowSeconds;
+
+RollingWindow::RollingWindow() : origin_(std::chrono::steady_clock::now()) {}
+
+int64_t RollingWindow::NowSecond() const {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - origin_).count();
+}
+
+RollingWindow::Bucket& RollingWindow::Acquire(int64_t second) {
+    Bucket& bucket = buckets_[static_cast<size_t>(second) % kRingSeconds];
+    const int64_t tag = second + 1;
+    int64_t current = bucket.second.load(std::memory_order_acquire);
+    while (current != tag) {
+        if (current == kResetting) {
+            std::this_thread::yield();
+        } else if (current > tag) {
+            break;   // 记录者停顿超过一整圈，桶已属于更新的秒，计入其中 (可忽略的误差)
+        } else if (bucket.second.compare_exchange_weak(current, kResetting, std::memory_order_acq_rel)) {
+            bucket.requests.store(0, std::memory_order_relaxed);
+            bucket.errors.store(0, std::memory_order_relaxed);
+            bucket.empty_results.store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < kModeCount; ++i) {
+                bucket.compute_us[i].store(0, std::memory_order_relaxed);
+                bucket.audio_us[i].store(0, std::memory_order_relaxed);
+            }
+            bucket.second.store(tag, std::memory_order_release);
+            break;
+        } else {
+            continue;   // CAS失败时current已更新为最新值
+        }
+        current = bucket.second.load(std::memory_order_acquire);
+    }
+    return bucket;
+}
+
+void RollingWindow::Record(Mode mode, double compute_ms, double audio_seconds, bool has_text) {
+    Bucket& bucket = Acquire(NowSecond());
+    const size_t index = static_cast<size_t>(mode);
+    bucket.requests.fetch_add(1, std::memory_order_relaxed);
+    if (!has_text) {
+        bucket.empty_results.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (compute_ms > 0.0) {
+        bucket.compute_us[index].fetch_add(static_cast<uint64_t>(compute_ms * 1000.0), std::memory_order_relaxed);
+    }
+    if (audio_seconds > 0.0) {
+        bucket.audio_us[index].fetch_add(static_cast<uint64_t>(audio_seconds * 1e6), std::memory_order_relaxed);
+    }
+}
+
+void RollingWindow::RecordError() {
+    Bucket& bucket = Acquire(NowSecond());
+    bucket.requests.fetch_add(1, std::memory_order_relaxed);
+    bucket.errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RollingWindow::RecordFailure() {
+    Acquire(NowSecond()).errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<WindowStats> RollingWindow::Snapshot() const {
+    const int64_t now = NowSecond();
+    std::vector<WindowStats> windows;
+    windows.reserve(kWindowSeconds.size());
+    for (int seconds : kWindowSeconds) {
+        WindowStats stats;
+        stats.seconds = seconds;
+        uint64_t compute_us[kModeCount] = {};
+        uint64_t audio_us[kModeCount] = {};
+        // 只统计已结束的秒: [now - seconds, now - 1]
+        const int64_t first = std::max<int64_t>(0, now - seconds);
+        for (int64_t second = first; second < now; ++second) {
+            const Bucket& bucket = buckets_[static_cast<size_t>(second) % kRingSeconds];
+            if (bucket.second.load(std::memory_order_acquire) != second + 1) continue;
+            stats.requests += bucket.requests.load(std::memory_order_relaxed);
+            stats.errors += bucket.errors.load(std::memory_order_relaxed);
+            stats.empty_results += bucket.empty_results.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < kModeCount; ++i) {
+                compute_us[i] += bucket.compute_us[i].load(std::memory_order_relaxed);
+                audio_us[i] += bucket.audio_us[i].load(std::memory_order_relaxed);
+            }
+        }
+        // 启动不满一个窗口时按已运行的秒数折算
+        const double span = static_cast<double>(std::max<int64_t>(1, now - first));
+        uint64_t total_audio_us = 0;
+        for (size_t i = 0; i < kModeCount; ++i) total_audio_us += audio_us[i];
+        stats.requests_per_sec = stats.requests / span;
+        stats.audio_speed = total_audio_us / 1e6 / span;
+        // 精化失败计入所属请求之外，极端情况下错误数可超过请求数
+        stats.error_rate =
+            stats.requests > 0 ? std::min(1.0, static_cast<double>(stats.errors) / stats.requests) : 0.0;
+        auto rtf = [&](Mode mode) {
+            const size_t i = static_cast<size_t>(mode);
+            return audio_us[i] > 0 ? static_cast<double>(compute_us[i]) / audio_us[i] : 0.0;
+        };
+        stats.offline_rtf = rtf(Mode::kOffline);
+        stats.streaming_rtf = rtf(Mode::kStreaming);
+        stats.two_pass_rtf = rtf(Mode::kTwoPass);
+        windows.push_back(stats);
+    }
+    return windows;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * 滑动窗口统计结果 - 最近seconds秒 (不含当前未结束的一秒) 的吞吐/RTF/错误率
+ */
+struct WindowStats {
+    int seconds = 0;
+    uint64_t requests = 0;
+    uint64_t errors = 0;                 // 异常与未能精化的语音段 (真实失败)
+    uint64_t empty_results = 0;          // 无文本的请求 (如静音分块)，不计入错误
+    double requests_per_sec = 0.0;
+    double audio_speed = 0.0;            // 每墙钟秒处理的音频秒数
+    double error_rate = 0.0;             // 0-1，只反映真实失败
+    double offline_rtf = 0.0;            // 窗口内 Σ耗时 / Σ音频时长，无请求时为0
+    double streaming_rtf = 0.0;
+    double two_pass_rtf = 0.0;
+};
+
+/**
+ * 滑动窗口聚合 - 按秒分桶的环形缓冲，增量维护1秒/10秒/1分钟/5分钟窗口
+ *
+ * 🆕 PerformanceMetrics只有进程启动以来的累计值和"最近一次"RTF，长时间运行后看不出当前负载:
+ * - 每秒一个桶，共覆盖5分钟；记录时只对当前秒的桶做relaxed原子加
+ * - 桶按秒号复用: 首个进入新一秒的记录者把桶标记为重置中、清零后再发布新秒号，
+ *   其余记录者只在这段极短的清零期间自旋等待
+ * - Snapshot对窗口内已结束的秒求和，桶中秒号不在窗口内的直接跳过 (空闲期自然归零)
+ *
+ * 记录与读取都不加锁，读取期间的并发更新最多使结果相差一次记录。
+ */
+class RollingWindow {
+public:
+    enum class Mode : int {
+        kOffline = 0,
+        kStreaming,
+        kTwoPass,
+        kCount
+    };
+    static constexpr size_t kModeCount = static_cast<size_t>(Mode::kCount);
+
+    // 输出的窗口长度 (秒)
+    static constexpr std::array<int, 4> kWindowSeconds{{1, 10, 60, 300}};
+
+    RollingWindow();
+
+    /**
+     * 记录一次识别请求/分块: 耗时与处理的音频时长 (秒)
+     * has_text为false时计入空结果数 (静音分块的部分结果本就为空，不算错误)
+     */
+    void Record(Mode mode, double compute_ms, double audio_seconds, bool has_text = true);
+
+    /**
+     * 记录一次没有结果的失败请求 (异常，同时计入请求数)
+     */
+    void RecordError();
+
+    /**
+     * 记录已计入请求数的请求中发生的失败 (如2Pass语音段未能精化)，只增加错误数
+     */
+    void RecordFailure();
+
+    /**
+     * 各窗口的统计 (按kWindowSeconds顺序)
+     */
+    std::vector<WindowStats> Snapshot() const;
+
+private:
+    static constexpr size_t kRingSeconds = 302;        // 5分钟窗口 + 当前秒 + 余量
+    static constexpr int64_t kResetting = -1;
+
+    struct alignas(64) Bucket {
+        std::atomic<int64_t> second{0};                // 秒号+1 (0为未使用)
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> empty_results{0};
+        std::array<std::atomic<uint64_t>, kModeCount> compute_us{};
+        std::array<std::atomic<uint64_t>, kModeCount> audio_us{};
+    };
+
+    int64_t NowSecond() const;
+    Bucket& Acquire(int64_t second);
+
+    std::chrono::steady_clock::time_point origin_;
+    std::array<Bucket, kRingSeconds> buckets_;
+};
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 会话管理器 - 按ID分配会话句柄 + 预分配对象池 + 空闲淘汰
+ *
+ * 🆕 替代测试循环中临时创建的栈上会话:
+ * - 会话对象预先创建并预留缓冲区，关闭后重置放回池中，不必每次重新分配数MB缓冲与缓存
+ * - 同时打开的会话不超过max_sessions，超出时Open返回明确的拒绝原因
+ * - 超过idle_timeout未活动的会话由后台线程关闭，释放名额
+ *
+ * 句柄为shared_ptr: 会话关闭 (或被淘汰) 后，最后一个句柄释放时才重置并回池，
+ * 调用方持有句柄期间对象始终有效。Session需提供Touch()与LastActivity() (steady_clock时间点)。
+ */
+template <typename Session>
+class SessionManager {
+public:
+    using Clock = std::chrono::steady_clock;
+    using SessionPtr = std::shared_ptr<Session>;
+    using Factory = std::function<std::unique_ptr<Session>()>;
+    using Recycler = std::function<void(Session&)>;
+
+    enum class Status { kOk, kDuplicateId, kCapacityExceeded };
+
+    struct Admission {
+        Status status = Status::kOk;
+        SessionPtr session;
+        std::string error;               // 拒绝原因 (status不为kOk时)
+
+        bool Ok() const { return status == Status::kOk; }
+    };
+
+    struct Stats {
+        size_t active = 0;               // 当前打开的会话数
+        size_t pooled = 0;               // 池中空闲对象数
+        size_t peak_active = 0;          // 峰值打开会话数
+        uint64_t opened = 0;             // 成功打开次数
+        uint64_t reused = 0;             // 其中复用池中对象的次数
+        uint64_t rejected = 0;           // 被拒绝的打开请求
+        uint64_t evicted = 0;            // 因空闲被关闭的会话
+    };
+
+    /**
+     * @param max_sessions 同时打开的会话上限
+     * @param pool_size 预分配的对象数 (回池对象最多保留max(pool_size, max_sessions)个)
+     * @param idle_timeout 空闲超时 (0表示不淘汰)
+     * @param factory 创建会话对象 (在此预留缓冲区)
+     * @param recycler 回池前重置会话 (在释放最后一个句柄的线程中调用)
+     */
+    SessionManager(size_t max_sessions, size_t pool_size, std::chrono::milliseconds idle_timeout,
+                   Factory factory, Recycler recycler)
+        : max_sessions_(std::max<size_t>(1, max_sessions)),
+          idle_timeout_(idle_timeout),
+          factory_(std::move(factory)),
+          pool_(std::make_shared<Pool>()) {
+        pool_->capacity = std::max(pool_size, max_sessions_);
+        pool_->recycler = std::move(recycler);
+        for (size_t i = 0; i < pool_size; ++i) {
+            pool_->free.push_back(factory_());
+        }
+        if (idle_timeout_.count() > 0) {
+            reaper_ = std::thread(&SessionManager::ReaperLoop, this);
+        }
+    }
+
+    // 关闭全部会话；仍被外部持有的对象在句柄释放时直接销毁
+    ~SessionManager() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        reaper_cv_.notify_all();
+        if (reaper_.joinable()) reaper_.join();
+        std::unordered_map<std::string, SessionPtr> closing;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closing.swap(sessions_);
+        }
+        closing.clear();
+    }
+
+    SessionManager(const SessionManager&) = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+
+    /**
+     * 打开会话 - 达到上限时先关闭已超时的空闲会话，仍无名额则拒绝
+     */
+    Admission Open(const std::string& session_id) {
+        Admission admission;
+        std::vector<SessionPtr> evicted;
+        std::unique_ptr<Session> object;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (sessions_.count(session_id)) {
+                stats_.rejected++;
+                admission.status = Status::kDuplicateId;
+                admission.error = "会话ID已存在: " + session_id;
+                return admission;
+            }
+            if (sessions_.size() >= max_sessions_) {
+                CollectIdleLocked(Clock::now(), evicted);
+            }
+            if (sessions_.size() >= max_sessions_) {
+                stats_.rejected++;
+                admission.status = Status::kCapacityExceeded;
+                admission.error = "并发会话数已达上限(" + std::to_string(max_sessions_) + ")，拒绝会话: " + session_id;
+                return admission;
+            }
+            object = pool_->Take();
+            if (object) stats_.reused++;
+        }
+        if (!object) object = factory_();
+        object->Touch();
+
+        std::weak_ptr<Pool> pool = pool_;
+        SessionPtr session(object.release(), [pool](Session* raw) {
+            std::unique_ptr<Session> owned(raw);
+            if (auto alive = pool.lock()) alive->Return(std::move(owned));
+        });
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (sessions_.count(session_id)) {
+                // 两个线程同时打开同一ID: 后到者放弃 (session在此作用域结束时回池)
+                stats_.rejected++;
+                admission.status = Status::kDuplicateId;
+                admission.error = "会话ID已存在: " + session_id;
+                return admission;
+            }
+            sessions_.emplace(session_id, session);
+            stats_.opened++;
+            stats_.peak_active = std::max(stats_.peak_active, sessions_.size());
+        }
+        admission.session = std::move(session);
+        return admission;
+    }
+
+    /**
+     * 按ID查找会话，不存在 (或已被淘汰) 时返回nullptr
+     */
+    SessionPtr Get(const std::string& session_id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(session_id);
+        return it != sessions_.end() ? it->second : nullptr;
+    }
+
+    /**
+     * 关闭会话，返回是否存在
+     */
+    bool Close(const std::string& session_id) {
+        SessionPtr closing;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = sessions_.find(session_id);
+            if (it == sessions_.end()) return false;
+            closing = std::move(it->second);
+            sessions_.erase(it);
+        }
+        return true;  // closing在锁外释放，回池重置不阻塞其他会话
+    }
+
+    /**
+     * 关闭所有超过空闲时间的会话，返回关闭数量
+     */
+    size_t EvictIdle() {
+        std::vector<SessionPtr> evicted;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            CollectIdleLocked(Clock::now(), evicted);
+        }
+        return evicted.size();
+    }
+
+    size_t MaxSessions() const { return max_sessions_; }
+
+    Stats GetStats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats stats = stats_;
+        stats.active = sessions_.size();
+        stats.pooled = pool_->Size();
+        return stats;
+    }
+
+private:
+    /**
+     * 空闲对象池 - 由句柄的删除器共享引用，管理器先销毁时删除器直接释放对象
+     */
+    struct Pool {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Session>> free;
+        size_t capacity = 0;
+        Recycler recycler;
+
+        std::unique_ptr<Session> Take() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (free.empty()) return nullptr;
+            auto object = std::move(free.back());
+            free.pop_back();
+            return object;
+        }
+
+        void Return(std::unique_ptr<Session> object) {
+            if (recycler) recycler(*object);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (free.size() < capacity) free.push_back(std::move(object));
+        }
+
+        size_t Size() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return free.size();
+        }
+    };
+
+    // 调用方持有mutex_；被淘汰的句柄移入evicted，由调用方在锁外释放
+    void CollectIdleLocked(Clock::time_point now, std::vector<SessionPtr>& evicted) {
+        if (idle_timeout_.count() <= 0) return;
+        for (auto it = sessions_.begin(); it != sessions_.end();) {
+            if (now - it->second->LastActivity() > idle_timeout_) {
+                evicted.push_back(std::move(it->second));
+                it = sessions_.erase(it);
+                stats_.evicted++;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void ReaperLoop() {
+        const auto interval = std::max<std::chrono::milliseconds>(idle_timeout_ / 4, std::chrono::milliseconds(100));
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            reaper_cv_.wait_for(lock, interval, [this]() { return stopping_; });
+            if (stopping_) break;
+            std::vector<SessionPtr> evicted;
+            CollectIdleLocked(Clock::now(), evicted);
+            lock.unlock();
+            evicted.clear();
+            lock.lock();
+        }
+    }
+
+    const size_t max_sessions_;
+    const std::chrono::milliseconds idle_timeout_;
+    Factory factory_;
+    std::shared_ptr<Pool> pool_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable reaper_cv_;
+    std::unordered_map<std::string, SessionPtr> sessions_;
+    Stats stats_;
+    bool stopping_ = false;
+    std::thread reaper_;
+};
@@ -0,0 +1,38 @@
+#include "sharded_metrics.h"
+#include <algorithm>
+
+namespace sharded_metrics {
+
+size_t ThreadShard() {
+    static std::atomic<size_t> next_thread{0};
+    thread_local const size_t shard = next_thread.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return shard;
+}
+
+}  // namespace sharded_metrics
+
+void ShardedHistogram::Record(double ms) {
+    if (!(ms > 0)) ms = 0.0;
+    Shard& shard = shards_[sharded_metrics::ThreadShard()];
+    shard.counts[LatencyHistogram::BucketIndexForMs(ms)].fetch_add(1, std::memory_order_relaxed);
+    const uint64_t ns = static_cast<uint64_t>(std::min(ms * 1e6, 1e18));
+    shard.sum_ns.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t current = shard.max_ns.load(std::memory_order_relaxed);
+    while (ns > current && !shard.max_ns.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram ShardedHistogram::Snapshot() const {
+    std::array<uint64_t, LatencyHistogram::kBucketCount> counts{};
+    uint64_t sum_ns = 0, max_ns = 0;
+    for (const auto& shard : shards_) {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] += shard.counts[i].load(std::memory_order_relaxed);
+        }
+        sum_ns += shard.sum_ns.load(std::memory_order_relaxed);
+        max_ns = std::max(max_ns, shard.max_ns.load(std::memory_order_relaxed));
+    }
+    LatencyHistogram histogram;
+    histogram.AddBucketCounts(counts, sum_ns / 1e6, max_ns / 1e6);
+    return histogram;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "latency_histogram.h"
+
+/**
+ * 分片计数器与直方图 - 识别热路径上的无锁指标更新
+ *
+ * 🆕 每次分块/请求完成都要更新指标，统一加metrics_mutex_在数百次/秒时成为竞争点:
+ * - 数据分成kShards个缓存行对齐的分片，线程按自己的序号固定写入其中一个
+ * - 更新只用relaxed原子操作 (同一分片偶有多个线程共用，仍然正确)
+ * - 读取时逐分片求和，得到近似同一时刻的快照，不阻塞写入
+ */
+namespace sharded_metrics {
+
+constexpr size_t kShards = 16;
+
+/**
+ * 当前线程的分片序号 (首次调用时按线程创建顺序分配)
+ */
+size_t ThreadShard();
+
+}  // namespace sharded_metrics
+
+/**
+ * 分片计数器
+ */
+class ShardedCounter {
+public:
+    void Add(uint64_t n = 1) {
+        cells_[sharded_metrics::ThreadShard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t Sum() const {
+        uint64_t sum = 0;
+        for (const auto& cell : cells_) sum += cell.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Cell, sharded_metrics::kShards> cells_;
+};
+
+/**
+ * 分片延迟直方图 - 与LatencyHistogram分桶一致，Snapshot合并为LatencyHistogram
+ */
+class ShardedHistogram {
+public:
+    void Record(double ms);
+    LatencyHistogram Snapshot() const;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, LatencyHistogram::kBucketCount> counts{};
+        std::atomic<uint64_t> sum_ns{0};     // 整数纳秒累加，避免double原子加
+        std::atomic<uint64_t> max_ns{0};
+    };
+    std::array<Shard, sharded_metrics::kShards> shards_;
+};
@@ -0,0 +1,27 @@
+#include "stage_profiler.h"
+
+const char* StageProfiler::StageName(Stage stage) {
+    switch (stage) {
+        case Stage::kResample: return "resample";
+        case Stage::kGilWait: return "gil_wait";
+        case Stage::kToNumpy: return "to_numpy";
+        case Stage::kOfflineGenerate: return "offline_generate";
+        case Stage::kStreamingGenerate: return "streaming_generate";
+        case Stage::kVadGenerate: return "vad_generate";
+        case Stage::kPuncGenerate: return "punc_generate";
+        case Stage::kParse: return "parse";
+        case Stage::kStreamingWait: return "streaming_wait";
+        case Stage::kCount: break;
+    }
+    return "unknown";
+}
+
+void StageProfiler::Record(Stage stage, double ms) {
+    stages_[static_cast<size_t>(stage)].Record(ms);
+}
+
+std::array<LatencyHistogram, StageProfiler::kStageCount> StageProfiler::Snapshot() const {
+    std::array<LatencyHistogram, kStageCount> snapshot;
+    for (size_t i = 0; i < kStageCount; ++i) snapshot[i] = stages_[i].Snapshot();
+    return snapshot;
+}
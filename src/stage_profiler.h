@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include "latency_histogram.h"
+#include "sharded_metrics.h"
+#include "trace_recorder.h"
+
+/**
+ * 识别阶段耗时统计 - RAII计时区间，按阶段汇总为延迟直方图
+ *
+ * 🆕 RecognitionResult只有一个inference_time_ms，分不清时间花在C++侧还是模型调用里:
+ * - 重采样、numpy转换、等待GIL、generate、结果解析等各记为一个阶段
+ * - 区间用steady_clock计时 (纳秒精度)，析构或End()时记入该阶段的直方图；
+ *   启用TraceRecorder时同时作为"stage"事件写入追踪
+ * - 每个阶段一个分片直方图，记录只做relaxed原子加，不同线程/阶段互不竞争
+ *
+ * 阶段名使用ASCII标识，可直接作为导出指标的标签。
+ */
+class StageProfiler {
+public:
+    enum class Stage : int {
+        kResample = 0,           // 音频重采样
+        kGilWait,                // 等待获取GIL
+        kToNumpy,                // C++音频转numpy数组
+        kOfflineGenerate,        // 离线ASR模型调用
+        kStreamingGenerate,      // 流式ASR模型调用
+        kVadGenerate,            // VAD模型调用
+        kPuncGenerate,           // 标点模型调用
+        kParse,                  // 解析Python结果
+        kStreamingWait,          // 2Pass等待并行的流式识别完成
+        kCount
+    };
+    static constexpr size_t kStageCount = static_cast<size_t>(Stage::kCount);
+
+    static const char* StageName(Stage stage);
+
+    /**
+     * 计时区间 - 构造时开始，析构或End()时记录 (End可提前调用，之后析构不再重复记录)
+     */
+    class Span {
+    public:
+        Span(StageProfiler& profiler, Stage stage)
+            : profiler_(&profiler), stage_(stage), start_(std::chrono::steady_clock::now()) {}
+        ~Span() { End(); }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        // 返回本次记录的毫秒数 (已结束时返回0)
+        double End() {
+            if (!profiler_) return 0.0;
+            const auto end = std::chrono::steady_clock::now();
+            const double ms = std::chrono::duration<double, std::milli>(end - start_).count();
+            profiler_->Record(stage_, ms);
+            if (TraceRecorder::Instance().IsEnabled()) {
+                TraceRecorder::Instance().Record("stage", StageName(stage_), start_, end);
+            }
+            profiler_ = nullptr;
+            return ms;
+        }
+
+        // 放弃本次计时 (之后End与析构都不再记录)
+        void Cancel() { profiler_ = nullptr; }
+
+    private:
+        StageProfiler* profiler_;
+        Stage stage_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    void Record(Stage stage, double ms);
+
+    /**
+     * 各阶段直方图的快照 (按Stage顺序)
+     */
+    std::array<LatencyHistogram, kStageCount> Snapshot() const;
+
+private:
+    std::array<ShardedHistogram, kStageCount> stages_;
+};
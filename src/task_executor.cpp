@@ -0,0 +1,174 @@
+#include "task_executor.h"
+#include "utils.h"
+#include <algorithm>
+
+namespace {
+// 当前线程所属的执行器 (非执行器线程为nullptr)
+thread_local const TaskExecutor* current_executor = nullptr;
+
+constexpr size_t kLatency = static_cast<size_t>(TaskExecutor::TaskClass::kLatency);
+constexpr size_t kThroughput = static_cast<size_t>(TaskExecutor::TaskClass::kThroughput);
+}
+
+TaskExecutor::TaskExecutor(int num_threads, size_t queue_capacity, double latency_share, int aging_ms)
+    : capacity_(std::max<size_t>(1, queue_capacity)),
+      aging_(std::max(0, aging_ms)) {
+    num_threads = std::max(1, num_threads);
+    latency_share = std::min(0.99, std::max(0.01, latency_share));
+    classes_[kLatency].share = latency_share;
+    classes_[kThroughput].share = 1.0 - latency_share;
+    throughput_limit_ = std::max(1, num_threads - 1);
+    for (int i = 0; i < num_threads; ++i) {
+        threads_.emplace_back(&TaskExecutor::WorkerLoop, this);
+    }
+}
+
+TaskExecutor::~TaskExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+bool TaskExecutor::IsWorkerThread() const {
+    return current_executor == this;
+}
+
+size_t TaskExecutor::QueueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_;
+}
+
+TaskExecutor::Stats TaskExecutor::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto fill = [](const ClassState& state) {
+        ClassStats stats;
+        stats.executed = state.executed;
+        stats.aged = state.aged;
+        stats.queued = state.queue.size();
+        stats.running = state.running;
+        stats.max_wait_ms = state.max_wait_ms;
+        stats.busy_ms = state.busy_ms;
+        if (state.executed > 0) stats.avg_wait_ms = state.total_wait_ms / state.executed;
+        return stats;
+    };
+    Stats stats;
+    stats.latency = fill(classes_[kLatency]);
+    stats.throughput = fill(classes_[kThroughput]);
+    return stats;
+}
+
+void TaskExecutor::Enqueue(TaskClass task_class, Task task) {
+    const size_t index = static_cast<size_t>(task_class);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!stopping_ && queued_ >= capacity_ && IsWorkerThread()) {
+            // 执行器线程阻塞等待队列空位可能导致全部线程互等，直接内联执行
+            lock.unlock();
+            RunTask(task);
+            return;
+        }
+        not_full_.wait(lock, [this]() { return stopping_ || queued_ < capacity_; });
+        if (!stopping_) {
+            ClassState& state = classes_[index];
+            // 空闲后重新活跃的类别从对方的虚拟时间起步，不因空闲期积累份额而突发占满线程
+            if (state.queue.empty() && state.running == 0) {
+                state.virtual_time = std::max(state.virtual_time, classes_[1 - index].virtual_time);
+            }
+            state.queue.push_back({std::move(task), Clock::now()});
+            queued_++;
+            lock.unlock();
+            not_empty_.notify_all();
+            return;
+        }
+    }
+    // 执行器已停止: 在调用线程执行，保证future总能完成
+    RunTask(task);
+}
+
+bool TaskExecutor::PopNext(bool respect_limit, Task& task, size_t& class_index) {
+    ClassState& latency = classes_[kLatency];
+    ClassState& throughput = classes_[kThroughput];
+    const bool has_latency = !latency.queue.empty();
+    const bool has_throughput = !throughput.queue.empty() &&
+        (!respect_limit || throughput.running < throughput_limit_);
+    if (!has_latency && !has_throughput) return false;
+    
+    auto now = Clock::now();
+    bool aged = false;
+    if (has_latency && has_throughput) {
+        aged = now - throughput.queue.front().enqueue_time > aging_;
+        class_index = aged || throughput.virtual_time < latency.virtual_time ? kThroughput : kLatency;
+    } else {
+        class_index = has_latency ? kLatency : kThroughput;
+    }
+    
+    ClassState& state = classes_[class_index];
+    double wait_ms = std::chrono::duration<double, std::milli>(now - state.queue.front().enqueue_time).count();
+    task = std::move(state.queue.front().task);
+    state.queue.pop_front();
+    queued_--;
+    state.running++;
+    state.total_wait_ms += wait_ms;
+    state.max_wait_ms = std::max(state.max_wait_ms, wait_ms);
+    if (aged) state.aged++;
+    return true;
+}
+
+void TaskExecutor::Execute(Task& task, size_t class_index) {
+    not_full_.notify_one();
+    auto start = Clock::now();
+    RunTask(task);
+    double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ClassState& state = classes_[class_index];
+        state.running--;
+        state.executed++;
+        state.busy_ms += elapsed_ms;
+        state.virtual_time += elapsed_ms / state.share;
+    }
+    // 吞吐任务结束可能解除线程上限，唤醒等待的线程
+    if (class_index == kThroughput) not_empty_.notify_one();
+}
+
+bool TaskExecutor::RunPendingTask() {
+    Task task;
+    size_t class_index = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!PopNext(false, task, class_index)) return false;
+    }
+    Execute(task, class_index);
+    return true;
+}
+
+void TaskExecutor::RunTask(Task& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        Logger::Error("执行器任务异常: {}", e.what());
+    }
+}
+
+void TaskExecutor::WorkerLoop() {
+    current_executor = this;
+    while (true) {
+        Task task;
+        size_t class_index = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_.wait(lock, [&]() {
+                return PopNext(true, task, class_index) || (stopping_ && queued_ == 0);
+            });
+            // 停止时仍执行完已排队任务
+            if (!task) return;
+        }
+        Execute(task, class_index);
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 引擎级共享执行器 - 固定线程数 + 有界任务队列
+ * 
+ * 🆕 替代每个音频块/语音段临时创建线程的 std::async 与分离线程:
+ * - 线程数固定，CPU占用与内存可预期
+ * - 队列满时提交方阻塞 (在执行器线程内提交则直接内联执行，避免自锁)
+ * - 执行器线程等待嵌套提交的结果时协助执行队列中的任务 (Wait)
+ * 
+ * 🆕 QoS: 任务分为低延迟 (2Pass第一遍流式识别) 与吞吐 (离线/精化) 两类:
+ * - 两类都有任务排队时按CPU份额选取 (按已消耗执行时间/份额的虚拟时间，小者优先)
+ * - 吞吐任务最多占用 线程数-1 个线程，始终留一个线程给低延迟任务
+ * - 吞吐任务排队超过aging_ms后优先执行，不会饿死
+ * 调度只发生在任务边界，正在执行的任务不会被打断。
+ */
+class TaskExecutor {
+public:
+    using Task = std::function<void()>;
+    
+    enum class TaskClass { kLatency = 0, kThroughput = 1 };
+    
+    struct ClassStats {
+        uint64_t executed = 0;           // 已执行任务数
+        uint64_t aged = 0;               // 因等待超时被提前执行的任务数
+        size_t queued = 0;               // 当前排队数
+        int running = 0;                 // 当前执行中
+        double avg_wait_ms = 0.0;        // 平均排队时间
+        double max_wait_ms = 0.0;        // 最大排队时间
+        double busy_ms = 0.0;            // 累计执行时间
+    };
+    
+    struct Stats {
+        ClassStats latency;
+        ClassStats throughput;
+    };
+    
+    /**
+     * @param latency_share 低延迟任务的CPU份额 (0-1，两类都繁忙时生效)
+     * @param aging_ms 吞吐任务的最长排队时间，超过后优先执行
+     */
+    TaskExecutor(int num_threads, size_t queue_capacity, double latency_share = 0.8, int aging_ms = 1000);
+    ~TaskExecutor();
+    
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+    
+    /**
+     * 提交任务并返回future (异常通过future传递)
+     */
+    template <typename F>
+    auto Submit(TaskClass task_class, F&& func) -> std::future<decltype(func())> {
+        using Result = decltype(func());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+        auto future = task->get_future();
+        Enqueue(task_class, [task]() { (*task)(); });
+        return future;
+    }
+    
+    /**
+     * 提交无返回值任务 (完成通知由任务自身回调负责，异常只记录日志)
+     */
+    void Post(TaskClass task_class, Task task) { Enqueue(task_class, std::move(task)); }
+    
+    /**
+     * 等待future - 在执行器线程中调用时先执行排队任务，避免所有线程互相等待
+     */
+    template <typename T>
+    T Wait(std::future<T>& future) {
+        if (IsWorkerThread()) {
+            while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                if (!RunPendingTask()) {
+                    future.wait_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+        return future.get();
+    }
+    
+    bool IsWorkerThread() const;
+    int NumThreads() const { return static_cast<int>(threads_.size()); }
+    size_t QueueDepth() const;
+    Stats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct QueuedTask {
+        Task task;
+        Clock::time_point enqueue_time;
+    };
+    
+    struct ClassState {
+        std::deque<QueuedTask> queue;
+        double share = 0.5;
+        double virtual_time = 0.0;       // 执行时间/份额
+        int running = 0;
+        uint64_t executed = 0;
+        uint64_t aged = 0;
+        double total_wait_ms = 0.0;
+        double max_wait_ms = 0.0;
+        double busy_ms = 0.0;
+    };
+    
+    void Enqueue(TaskClass task_class, Task task);
+    bool RunPendingTask();
+    void WorkerLoop();
+    // 调用方持有mutex_；respect_limit为false时忽略吞吐任务的线程上限 (协助等待时使用)
+    bool PopNext(bool respect_limit, Task& task, size_t& class_index);
+    void Execute(Task& task, size_t class_index);
+    static void RunTask(Task& task);
+    
+    const size_t capacity_;
+    const std::chrono::milliseconds aging_;
+    int throughput_limit_ = 1;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::array<ClassState, 2> classes_;
+    size_t queued_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
@@ -0,0 +1,100 @@
+#include "trace_recorder.h"
+#include "utils.h"
+#include <fstream>
+
+TraceRecorder::Scope::Scope(const char* category, const char* name, const std::string& session, int64_t chunk)
+    : category_(category), name_(name), chunk_(chunk), active_(TraceRecorder::Instance().IsEnabled()) {
+    if (!active_) return;
+    session_ = session;
+    start_ = Clock::now();
+}
+
+TraceRecorder::Scope::~Scope() {
+    if (!active_) return;
+    TraceRecorder::Instance().Record(category_, name_, start_, Clock::now(), session_, chunk_);
+}
+
+TraceRecorder& TraceRecorder::Instance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+void TraceRecorder::Enable(size_t events_per_thread) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (enabled_.load()) return;
+    events_per_thread_ = std::max<size_t>(1, events_per_thread);
+    epoch_ = Clock::now();
+    enabled_.store(true);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::LocalBuffer() {
+    thread_local ThreadBuffer* local = nullptr;
+    if (local) return local;
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->events.resize(events_per_thread_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer->tid = static_cast<int>(buffers_.size()) + 1;
+    local = buffer.get();
+    buffers_.push_back(std::move(buffer));
+    return local;
+}
+
+void TraceRecorder::Record(const char* category, const char* name, Clock::time_point start, Clock::time_point end,
+                           const std::string& session, int64_t chunk) {
+    if (!IsEnabled()) return;
+    ThreadBuffer* buffer = LocalBuffer();
+    const size_t index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= buffer->events.size()) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Event& event = buffer->events[index];
+    event.category = category;
+    event.name = name;
+    event.ts_us = std::chrono::duration_cast<std::chrono::microseconds>(start - epoch_).count();
+    event.dur_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    event.chunk = chunk;
+    event.session = session;
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::WriteChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        Logger::Error("无法创建追踪文件: {}", path);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& buffer : buffers_) {
+        const size_t count = buffer->size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const Event& event = buffer->events[i];
+            out << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << event.ts_us
+                << ",\"dur\":" << event.dur_us;
+            if (!event.session.empty() || event.chunk >= 0) {
+                out << ",\"args\":{";
+                if (!event.session.empty()) out << "\"session\":\"" << JsonEscape(event.session) << "\"";
+                if (event.chunk >= 0) out << (event.session.empty() ? "" : ",") << "\"chunk\":" << event.chunk;
+                out << "}";
+            }
+            out << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return out.good();
+}
+
+TraceRecorder::Stats TraceRecorder::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.threads = buffers_.size();
+    for (const auto& buffer : buffers_) {
+        stats.recorded += buffer->size.load(std::memory_order_acquire);
+        stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
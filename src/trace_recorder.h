@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * 引擎活动追踪 - 进程级单例，导出Chrome trace-event JSON (可在Perfetto/chrome://tracing打开)
+ *
+ * 🆕 32路并发时只看汇总指标，看不出模型调用如何交错、在哪里阻塞:
+ * - 每个线程首次记录时分配自己的定长缓冲，只由本线程追加，无锁；写满后丢弃并计数
+ * - 请求 (离线/流式/2Pass/VAD/精化) 与识别阶段 (含GIL等待) 记为完整区间事件，
+ *   请求事件带会话ID与分块序号
+ * - 未启用时每个区间只多一次原子读
+ *
+ * Enable须在产生事件的线程启动前调用；导出可与记录并发进行 (只导出已完成的事件)。
+ */
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t recorded = 0;       // 缓冲中的事件数
+        uint64_t dropped = 0;        // 缓冲写满后丢弃的事件数
+        size_t threads = 0;          // 产生过事件的线程数
+    };
+
+    /**
+     * 记录区间 - 构造时开始，析构时结束；未启用追踪时不做任何事
+     */
+    class Scope {
+    public:
+        Scope(const char* category, const char* name, const std::string& session = std::string(), int64_t chunk = -1);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* category_;
+        const char* name_;
+        std::string session_;
+        int64_t chunk_;
+        bool active_;
+        Clock::time_point start_;
+    };
+
+    static TraceRecorder& Instance();
+
+    /**
+     * 启用追踪
+     * @param events_per_thread 每个线程缓冲的事件数上限
+     */
+    void Enable(size_t events_per_thread);
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * 记录一个完整区间 (category/name须为静态字符串)
+     */
+    void Record(const char* category, const char* name, Clock::time_point start, Clock::time_point end,
+                const std::string& session = std::string(), int64_t chunk = -1);
+
+    /**
+     * 写出Chrome trace-event JSON
+     */
+    bool WriteChromeTrace(const std::string& path) const;
+
+    Stats GetStats() const;
+
+private:
+    TraceRecorder() = default;
+
+    struct Event {
+        const char* category = nullptr;
+        const char* name = nullptr;
+        int64_t ts_us = 0;
+        int64_t dur_us = 0;
+        int64_t chunk = -1;
+        std::string session;
+    };
+
+    // 单生产者缓冲: 本线程写入events[size]后以release发布size，导出线程以acquire读取
+    struct ThreadBuffer {
+        int tid = 0;
+        std::vector<Event> events;
+        std::atomic<size_t> size{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    ThreadBuffer* LocalBuffer();
+
+    std::atomic<bool> enabled_{false};
+    size_t events_per_thread_ = 0;
+    Clock::time_point epoch_;
+
+    mutable std::mutex mutex_;                              // 保护buffers_列表 (不保护缓冲内容)
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
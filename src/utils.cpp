@@ -1,66 +1,127 @@
 #include "utils.h"
+#include <cmath>
 
 /**
  * Logger 日志等级实现（建议放头文件后专门实现）
  */
 Logger::Level Logger::current_level_ = Logger::INFO;
 
+/**
+ * 解析 WAV 头部：按 RIFF 块遍历，定位 fmt 与 data 块
+ */
+bool AudioFileReader::ReadWavHeader(std::istream& stream, WavHeader& header) {
+    char riff[12];
+    stream.read(riff, 12);
+    if (stream.gcount() != 12 || std::string(riff, 4) != "RIFF" || std::string(riff + 8, 4) != "WAVE") {
+        return false;
+    }
+    bool has_fmt = false;
+    char chunk_header[8];
+    while (stream.read(chunk_header, 8) && stream.gcount() == 8) {
+        std::string chunk_id(chunk_header, 4);
+        uint32_t chunk_size = *reinterpret_cast<uint32_t*>(chunk_header + 4);
+        if (chunk_id == "fmt ") {
+            if (chunk_size < 16) return false;   // 损坏的fmt块，否则下面的跳过长度会下溢
+            char fmt[16];
+            stream.read(fmt, 16);
+            if (stream.gcount() != 16) return false;
+            header.channels = *reinterpret_cast<uint16_t*>(fmt + 2);
+            header.sample_rate = *reinterpret_cast<int32_t*>(fmt + 4);
+            header.bits_per_sample = *reinterpret_cast<uint16_t*>(fmt + 14);
+            has_fmt = true;
+            stream.seekg(chunk_size - 16 + (chunk_size & 1), std::ios::cur);
+        } else if (chunk_id == "data") {
+            header.data_offset = static_cast<uint64_t>(stream.tellg());
+            header.data_size = chunk_size;
+            return has_fmt;
+        } else {
+            // 跳过 LIST 等扩展块（块长度按偶数对齐）
+            stream.seekg(chunk_size + (chunk_size & 1), std::ios::cur);
+        }
+    }
+    return false;
+}
+
+/**
+ * 打开 WAV 文件并定位到 data 块，仅支持 16 位 PCM
+ */
+bool WavStreamReader::Open(const std::string& file_path) {
+    file_.open(file_path, std::ios::binary);
+    if (!file_.is_open()) {
+        Logger::Error("无法打开音频文件: {}", file_path);
+        return false;
+    }
+    if (!AudioFileReader::ReadWavHeader(file_, header_)) {
+        Logger::Error("不是有效的WAV文件: {}", file_path);
+        file_.close();
+        return false;
+    }
+    if (header_.bits_per_sample != 16 || header_.channels <= 0) {
+        Logger::Error("暂不支持{}位音频，请转换为16位PCM格式: {}", header_.bits_per_sample, file_path);
+        file_.close();
+        return false;
+    }
+    frames_read_ = 0;
+    return true;
+}
+
+/**
+ * 读取一块音频：归一化并混合为单声道，复用内部缓冲避免整文件拷贝
+ */
+size_t WavStreamReader::Read(size_t max_frames, std::vector<float>& out) {
+    out.clear();
+    if (!file_.is_open() || IsEof()) {
+        return 0;
+    }
+    size_t frames = static_cast<size_t>(std::min<uint64_t>(max_frames, header_.FrameCount() - frames_read_));
+    const int channels = header_.channels;
+    raw_buffer_.resize(frames * channels);
+    file_.read(reinterpret_cast<char*>(raw_buffer_.data()), raw_buffer_.size() * sizeof(int16_t));
+    frames = static_cast<size_t>(file_.gcount()) / (sizeof(int16_t) * channels);
+    
+    out.resize(frames);
+    const float scale = 1.0f / (32768.0f * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        int sum = 0;
+        for (int c = 0; c < channels; ++c) {
+            sum += raw_buffer_[i * channels + c];
+        }
+        out[i] = static_cast<float>(sum) * scale;
+    }
+    // 数据不完整时视为读完，避免上层死循环
+    frames_read_ = frames > 0 ? frames_read_ + frames : header_.FrameCount();
+    return frames;
+}
+
 /**
  * 读取 WAV 文件，16位 PCM 格式，附详细日志输出
+ * 
+ * 分块解码直接写入单声道 float 结果，不再保留整文件的 int16 与立体声临时副本
  */
 AudioFileReader::AudioData AudioFileReader::ReadWavFile(const std::string& file_path) {
     AudioData audio_data;
-    std::ifstream file(file_path, std::ios::binary);
-    if (!file.is_open()) {
-        Logger::Error("无法打开音频文件: {}", file_path);
-        return audio_data;
-    }
     try {
-        // 读取 WAV 头部
-        char header[44];
-        file.read(header, 44);
-        if (file.gcount() != 44) {
-            Logger::Error("WAV文件头部读取失败: {}", file_path);
-            return audio_data;
-        }
-        // 验证并解析
-        if (std::string(header, 4) != "RIFF" || std::string(header + 8, 4) != "WAVE") {
-            Logger::Error("不是有效的WAV文件: {}", file_path);
+        WavStreamReader reader;
+        if (!reader.Open(file_path)) {
             return audio_data;
         }
-        audio_data.channels = *reinterpret_cast<short*>(header + 22);
-        audio_data.sample_rate = *reinterpret_cast<int*>(header + 24);
-        int bits_per_sample = *reinterpret_cast<short*>(header + 34);
-        int data_size = *reinterpret_cast<int*>(header + 40);
-        if (bits_per_sample != 16) {
-            Logger::Error("暂不支持{}位音频，请转换为16位PCM格式: {}", bits_per_sample, file_path);
-            return audio_data;
+        const WavHeader& header = reader.Header();
+        audio_data.sample_rate = header.sample_rate;
+        audio_data.samples.reserve(header.FrameCount());
+        
+        std::vector<float> block;
+        while (reader.Read(64 * 1024, block) > 0) {
+            audio_data.samples.insert(audio_data.samples.end(), block.begin(), block.end());
         }
-        // 读取音频数据
-        std::vector<short> raw_data(data_size / 2);
-        file.read(reinterpret_cast<char*>(raw_data.data()), data_size);
-        if (file.gcount() != data_size) {
+        if (audio_data.samples.size() != header.FrameCount()) {
             Logger::Error("音频数据读取不完整: {}", file_path);
+            audio_data.samples.clear();
             return audio_data;
         }
-        // 格式归一化
-        audio_data.samples.resize(raw_data.size());
-        for (size_t i = 0; i < raw_data.size(); ++i) {
-            audio_data.samples[i] = static_cast<float>(raw_data[i]) / 32768.0f;
-        }
-        // 立体声转换
-        if (audio_data.channels == 2) {
-            std::vector<float> mono_samples;
-            mono_samples.reserve(audio_data.samples.size() / 2);
-            for (size_t i = 0; i < audio_data.samples.size(); i += 2) {
-                float left = audio_data.samples[i];
-                float right = audio_data.samples[i + 1];
-                mono_samples.push_back((left + right) / 2.0f);
-            }
-            audio_data.samples = std::move(mono_samples);
-            audio_data.channels = 1;
+        if (header.channels == 2) {
             Logger::Info("立体声转单声道完成");
         }
+        audio_data.channels = 1;
         // 音频时长计算
         audio_data.duration_seconds = static_cast<double>(audio_data.samples.size()) / audio_data.sample_rate;
         Logger::Info("音频读取成功: 时长={:.2f}秒, 样本数={}", audio_data.duration_seconds, audio_data.samples.size());
@@ -95,3 +156,53 @@ std::vector<std::string> AudioFileReader::ScanWavFiles(const std::string& direct
     }
     return wav_files;
 }
+
+/**
+ * 线性插值重采样
+ */
+std::vector<float> AudioFileReader::Resample(const std::vector<float>& samples, int from_rate, int to_rate) {
+    if (from_rate == to_rate || samples.empty() || from_rate <= 0 || to_rate <= 0) {
+        return samples;
+    }
+    double ratio = static_cast<double>(to_rate) / from_rate;
+    size_t new_size = static_cast<size_t>(samples.size() * ratio);
+    std::vector<float> resampled(new_size);
+    for (size_t i = 0; i < new_size; ++i) {
+        double src_index = i / ratio;
+        size_t idx = static_cast<size_t>(src_index);
+        if (idx + 1 < samples.size()) {
+            double frac = src_index - idx;
+            resampled[i] = samples[idx] * (1.0 - frac) + samples[idx + 1] * frac;
+        } else {
+            resampled[i] = samples.back();
+        }
+    }
+    return resampled;
+}
+
+LatencySummary LatencySummary::FromSamples(std::vector<double> samples_ms) {
+    LatencySummary summary;
+    summary.count = samples_ms.size();
+    if (samples_ms.empty()) return summary;
+    std::sort(samples_ms.begin(), samples_ms.end());
+    double sum = 0.0;
+    for (double value : samples_ms) sum += value;
+    // 最近秩法: 第 ceil(p × n) 个样本
+    auto percentile = [&samples_ms](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * samples_ms.size()));
+        return samples_ms[std::min(samples_ms.size(), std::max<size_t>(1, rank)) - 1];
+    };
+    summary.avg_ms = sum / samples_ms.size();
+    summary.p50_ms = percentile(0.50);
+    summary.p95_ms = percentile(0.95);
+    summary.p99_ms = percentile(0.99);
+    summary.max_ms = samples_ms.back();
+    return summary;
+}
+
+std::string LatencySummary::ToString() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << "平均" << avg_ms << " / P50 " << p50_ms << " / P95 " << p95_ms
+        << " / P99 " << p99_ms << " / 最大" << max_ms << "ms";
+    return oss.str();
+}
@@ -9,6 +9,12 @@
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include "latency_histogram.h"
+#include "rolling_window.h"
 
 /**
  * 轻量 Logger（日志输出类），支持流式格式化，中文注释，全局线程安全
@@ -18,6 +24,14 @@ public:
     enum Level { DEBUG, INFO, WARN, ERROR };
     static void SetLevel(Level level) { current_level_ = level; }
 
+    // 调试日志，默认级别下不输出 (热路径上的逐块日志用这一级)
+    template <typename... Args>
+    static void Debug(const std::string& format, Args&&... args) {
+        if (current_level_ <= DEBUG) {
+            Print("DEBUG", format, std::forward<Args>(args)...);
+        }
+    }
+
     // 信息日志流式拼接，兼容中文与多变量
     template <typename... Args>
     static void Info(const std::string& format, Args&&... args) {
@@ -42,6 +56,10 @@ public:
 
 private:
     static Level current_level_;
+    static std::mutex& OutputMutex() {
+        static std::mutex output_mutex;
+        return output_mutex;
+    }
     template <typename... Args>
     static void Print(const std::string& level, const std::string& format, Args&&... args) {
         auto now = std::chrono::system_clock::now();
@@ -50,6 +68,7 @@ private:
         oss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
 
         std::string message = FormatString(format, std::forward<Args>(args)...);
+        std::lock_guard<std::mutex> lock(OutputMutex());  // 多线程日志整行输出，避免交错
         std::cout << "[" << oss.str() << "] [" << level << "] " << message << std::endl;
     }
 
@@ -81,12 +100,49 @@ public:
     void Reset() { start_ = std::chrono::high_resolution_clock::now(); }
     double ElapsedMs() const {
         auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start_).count();
+        return std::chrono::duration<double, std::milli>(end - start_).count();
     }
 private:
     std::chrono::high_resolution_clock::time_point start_;
 };
 
+/**
+ * WAV 头部信息：逐块解析 RIFF，兼容 LIST 等扩展块
+ */
+struct WavHeader {
+    int sample_rate = 0;
+    int channels = 0;
+    int bits_per_sample = 0;
+    uint64_t data_offset = 0;   // data 块在文件中的起始偏移
+    uint64_t data_size = 0;     // data 块字节数
+    uint64_t FrameCount() const {
+        int frame_bytes = channels * bits_per_sample / 8;
+        return frame_bytes > 0 ? data_size / frame_bytes : 0;
+    }
+    double DurationSeconds() const {
+        return sample_rate > 0 ? static_cast<double>(FrameCount()) / sample_rate : 0.0;
+    }
+};
+
+/**
+ * 分块 WAV 读取器：按需解码 16 位 PCM，输出单声道 float，内存占用与块大小相关
+ */
+class WavStreamReader {
+public:
+    bool Open(const std::string& file_path);
+    // 读取至多 max_frames 帧到 out（覆盖写入），返回实际帧数，0 表示读完
+    size_t Read(size_t max_frames, std::vector<float>& out);
+    bool IsOpen() const { return file_.is_open(); }
+    bool IsEof() const { return frames_read_ >= header_.FrameCount(); }
+    const WavHeader& Header() const { return header_; }
+    uint64_t FramesRead() const { return frames_read_; }
+private:
+    std::ifstream file_;
+    WavHeader header_;
+    uint64_t frames_read_ = 0;
+    std::vector<int16_t> raw_buffer_;  // 单块复用的原始 PCM 缓冲
+};
+
 /**
  * 音频文件工具类：支持扫描、读取、转单声道等，全程兼容 CPU
  */
@@ -101,10 +157,57 @@ public:
             return !samples.empty() && sample_rate > 0 && channels > 0;
         }
     };
+    using AudioDataPtr = std::shared_ptr<const AudioData>;
     // 读取标准 WAV 文件
     static AudioData ReadWavFile(const std::string& file_path);
+    // 仅解析 WAV 头部（不读取音频数据）
+    static bool ReadWavHeader(std::istream& stream, WavHeader& header);
     // 扫描目录下所有 WAV 文件
     static std::vector<std::string> ScanWavFiles(const std::string& directory);
+    // 线性插值重采样（不输出日志，可在任意线程调用）
+    static std::vector<float> Resample(const std::vector<float>& samples, int from_rate, int to_rate);
+};
+
+/**
+ * JSON 字符串转义，用于 NDJSON 等结构化输出
+ */
+inline std::string JsonEscape(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size() + 8);
+    for (char c : text) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    escaped += buf;
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+/**
+ * 延迟样本汇总：平均值与分位数 (毫秒)
+ */
+struct LatencySummary {
+    size_t count = 0;
+    double avg_ms = 0.0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+
+    static LatencySummary FromSamples(std::vector<double> samples_ms);
+    // 形如 "平均12.3 / P50 10.1 / P95 20.5 / P99 30.2 / 最大41.0ms"
+    std::string ToString() const;
 };
 
 /**
@@ -118,10 +221,53 @@ struct PerformanceMetrics {
     double gpu_memory_gb = 0.0;
 
     double online_latency_ms = 0.0;
-    double offline_refinement_ms = 0.0;
+    double offline_refinement_ms = 0.0;      // 精化平均延迟 (入队到结果投递)
+    double refinement_queue_ms = 0.0;        // 精化平均排队时间
+    double refinement_max_latency_ms = 0.0;  // 精化最大延迟
+    uint64_t refinement_dropped = 0;         // 队列满未精化的语音段数
+    
+    // 流水线各阶段时间加权平均队列占用 (未启用流水线时为0)
+    double pipeline_vad_queue = 0.0;
+    double pipeline_asr_queue = 0.0;
+    double pipeline_punc_queue = 0.0;
+    double pipeline_asr_batch = 0.0;         // ASR阶段平均批大小
     double vad_processing_ms = 0.0;
     double punctuation_ms = 0.0;
 
+    // 各模式逐请求延迟分布 (离线请求/流式分块/2Pass分块/VAD调用/标点调用)
+    LatencyHistogram offline_latency;
+    LatencyHistogram streaming_latency;
+    LatencyHistogram two_pass_latency;
+    LatencyHistogram vad_latency;
+    LatencyHistogram punctuation_latency;
+    // 识别各阶段耗时分布 (阶段名, 直方图)，只含有记录的阶段
+    std::vector<std::pair<std::string, LatencyHistogram>> stage_latency;
+
+    // 滑动窗口 (1秒/10秒/1分钟/5分钟) 的当前吞吐、RTF与错误率
+    std::vector<WindowStats> rolling_windows;
+
+    // 实时节奏流式压测 (未运行时为0)
+    int paced_sessions = 0;
+    double paced_rtf = 0.0;
+    double paced_latency_p50_ms = 0.0;       // 分块释放到部分结果返回
+    double paced_latency_p95_ms = 0.0;
+    double paced_latency_p99_ms = 0.0;
+    double paced_queue_p99_ms = 0.0;         // 分块释放到开始识别
+
+    // 开环离线压测: 每个提供负载一个点，构成延迟-负载曲线
+    struct LoadPoint {
+        double offered_rps = 0.0;
+        double achieved_rps = 0.0;
+        double queue_p99_ms = 0.0;
+        double latency_p50_ms = 0.0;
+        double latency_p99_ms = 0.0;
+    };
+    std::vector<LoadPoint> open_loop_curve;
+
+    // 容量搜索: 满足SLO的最大并发会话数 (未运行时为0)
+    int capacity_max_sessions = 0;
+    std::string capacity_bottleneck;
+
     int concurrent_sessions = 0;
     double total_audio_processed_hours = 0.0;
     uint64_t total_requests = 0;
@@ -142,11 +288,61 @@ struct PerformanceMetrics {
         oss << " 离线识别RTF: " << std::fixed << std::setprecision(4) << offline_rtf << "\n";
         oss << " 2Pass模式RTF: " << std::fixed << std::setprecision(4) << two_pass_rtf << "\n";
         oss << " 端到端延迟: " << std::fixed << std::setprecision(1) << end_to_end_latency_ms << "ms\n";
+        // 精化/流水线只在本次运行实际用到时输出 (批大小只在处理过批次后非0)
+        if (offline_refinement_ms > 0.0 || refinement_dropped > 0) {
+            oss << " 2Pass精化延迟: 平均" << std::fixed << std::setprecision(1) << offline_refinement_ms
+                << "ms (排队" << refinement_queue_ms << "ms), 最大" << refinement_max_latency_ms
+                << "ms, 丢弃" << refinement_dropped << "段\n";
+        }
+        if (pipeline_asr_batch > 0.0) {
+            oss << " 流水线队列占用: VAD " << std::fixed << std::setprecision(2) << pipeline_vad_queue
+                << " / ASR " << pipeline_asr_queue << " / 标点 " << pipeline_punc_queue
+                << ", ASR平均批大小 " << pipeline_asr_batch << "\n";
+        }
+        if (paced_sessions > 0) {
+            oss << " 实时节奏压测: " << paced_sessions << "路, RTF " << std::fixed << std::setprecision(4) << paced_rtf
+                << ", 部分结果延迟 P50/P95/P99 " << std::setprecision(1) << paced_latency_p50_ms << "/"
+                << paced_latency_p95_ms << "/" << paced_latency_p99_ms << "ms, 排队P99 " << paced_queue_p99_ms << "ms\n";
+        }
+        for (const auto& point : open_loop_curve) {
+            oss << " 开环负载 " << std::fixed << std::setprecision(2) << point.offered_rps << "请求/秒: 完成"
+                << point.achieved_rps << "请求/秒, 延迟P50/P99 " << std::setprecision(1) << point.latency_p50_ms
+                << "/" << point.latency_p99_ms << "ms, 排队P99 " << point.queue_p99_ms << "ms\n";
+        }
+        if (capacity_max_sessions > 0 || !capacity_bottleneck.empty()) {
+            oss << " 最大可持续并发: " << capacity_max_sessions << "路 (瓶颈: " << capacity_bottleneck << ")\n";
+        }
         oss << " 并发会话数: " << concurrent_sessions << "\n";
         oss << " GPU显存/CPU内存使用: " << std::fixed << std::setprecision(1) << gpu_memory_gb << "GB\n";
         oss << " 测试文件数: " << test_files_count << " 个WAV文件\n";
         oss << " 处理音频总时长: " << std::fixed << std::setprecision(1) << total_audio_processed_hours << " 小时\n";
         oss << " 成功率: " << std::fixed << std::setprecision(1) << GetSuccessRate() << "%\n";
+        bool window_active = false;
+        for (const auto& window : rolling_windows) window_active = window_active || window.requests > 0;
+        if (window_active) {
+            oss << "🕒 近期负载 (滑动窗口):\n";
+            for (const auto& window : rolling_windows) {
+                oss << " " << std::setw(4) << window.seconds << "秒: " << std::fixed << std::setprecision(2)
+                    << window.requests_per_sec << "请求/秒, 音频" << window.audio_speed << "秒/秒, RTF 离线/流式/2Pass "
+                    << std::setprecision(4) << window.offline_rtf << "/" << window.streaming_rtf << "/"
+                    << window.two_pass_rtf << ", 错误率" << std::setprecision(1) << window.error_rate * 100.0 << "%\n";
+            }
+        }
+        if (offline_latency.Count() + streaming_latency.Count() + two_pass_latency.Count() +
+            vad_latency.Count() + punctuation_latency.Count() > 0) {
+            oss << "📈 延迟分布:\n";
+            if (offline_latency.Count() > 0) oss << " 离线识别: " << offline_latency.ToString() << "\n";
+            if (streaming_latency.Count() > 0) oss << " 流式分块: " << streaming_latency.ToString() << "\n";
+            if (two_pass_latency.Count() > 0) oss << " 2Pass分块: " << two_pass_latency.ToString() << "\n";
+            if (vad_latency.Count() > 0) oss << " VAD检测: " << vad_latency.ToString() << "\n";
+            if (punctuation_latency.Count() > 0) oss << " 标点恢复: " << punctuation_latency.ToString() << "\n";
+        }
+        if (!stage_latency.empty()) {
+            oss << "⏱️ 阶段耗时分布:\n";
+            for (const auto& stage : stage_latency) {
+                oss << " " << std::left << std::setw(18) << stage.first << std::right << " " << stage.second.ToString() << "\n";
+            }
+        }
         oss << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
         return oss.str();
     }
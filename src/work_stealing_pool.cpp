@@ -0,0 +1,113 @@
+#include "work_stealing_pool.h"
+#include "utils.h"
+
+WorkStealingPool::WorkStealingPool(int num_workers) {
+    num_workers = std::max(1, num_workers);
+    for (int i = 0; i < num_workers; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < num_workers; ++i) {
+        threads_.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    WaitIdle();
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void WorkStealingPool::Submit(Task task, int preferred_worker) {
+    int target = preferred_worker >= 0 && preferred_worker < NumWorkers()
+        ? preferred_worker : static_cast<int>(next_queue_++ % queues_.size());
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        queued_++;
+        unfinished_++;
+    }
+    wake_cv_.notify_one();
+}
+
+void WorkStealingPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    idle_cv_.wait(lock, [this]() { return unfinished_ == 0; });
+}
+
+WorkStealingPool::Stats WorkStealingPool::GetStats() const {
+    Stats stats;
+    stats.executed = executed_.load();
+    stats.stolen = stolen_.load();
+    return stats;
+}
+
+bool WorkStealingPool::PopLocal(int worker_id, Task& task) {
+    WorkerQueue& queue = *queues_[worker_id];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::Steal(int thief_id, Task& task) {
+    const int n = NumWorkers();
+    for (int offset = 1; offset < n; ++offset) {
+        WorkerQueue& victim = *queues_[(thief_id + offset) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::WorkerLoop(int worker_id) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+            if (stopping_ && queued_ == 0) return;
+            // 预占一个任务名额，保证下面一定能取到任务
+            queued_--;
+        }
+        
+        // Submit先入队再计数，每个预占名额都对应一个已入队任务；
+        // 仅在与其他线程交错取任务时需要重试
+        Task task;
+        bool stolen = false;
+        while (true) {
+            if (PopLocal(worker_id, task)) break;
+            if (Steal(worker_id, task)) {
+                stolen = true;
+                break;
+            }
+            std::this_thread::yield();
+        }
+        
+        try {
+            task(worker_id);
+        } catch (const std::exception& e) {
+            Logger::Error("工作窃取任务异常 (Worker-{}): {}", worker_id, e.what());
+        }
+        executed_++;
+        if (stolen) stolen_++;
+        
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            unfinished_--;
+            if (unfinished_ == 0) idle_cv_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 工作窃取线程池 - 识别任务 (文件/语音段) 的动态负载均衡
+ * 
+ * 🆕 每个工作线程维护自己的任务双端队列:
+ * - 本线程从队首取任务 (按提交顺序，长任务优先启动)
+ * - 空闲线程从其他线程的队尾窃取 (取走最后提交的短任务，收尾粒度更细)
+ * 静态分片中跑得慢的线程不再成为长尾，提交的任务也不会被丢弃。
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void(int worker_id)>;
+    
+    struct Stats {
+        uint64_t executed = 0;    // 已执行任务数
+        uint64_t stolen = 0;      // 其中被窃取执行的任务数
+    };
+    
+    explicit WorkStealingPool(int num_workers);
+    ~WorkStealingPool();
+    
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    /**
+     * 提交任务
+     * @param preferred_worker 放入哪个线程的队列 (-1 表示轮询分配)
+     */
+    void Submit(Task task, int preferred_worker = -1);
+    
+    /**
+     * 等待所有已提交任务执行完毕
+     */
+    void WaitIdle();
+    
+    int NumWorkers() const { return static_cast<int>(queues_.size()); }
+    Stats GetStats() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    
+    void WorkerLoop(int worker_id);
+    bool PopLocal(int worker_id, Task& task);
+    bool Steal(int thief_id, Task& task);
+    
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+    
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;      // 有新任务或停止
+    std::condition_variable idle_cv_;      // 所有任务完成
+    size_t queued_ = 0;                    // 队列中尚未被取走的任务数 (受wake_mutex_保护)
+    size_t unfinished_ = 0;                // 已提交未完成的任务数 (受wake_mutex_保护)
+    bool stopping_ = false;
+    
+    std::atomic<unsigned> next_queue_{0};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+};